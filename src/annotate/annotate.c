@@ -8,25 +8,15 @@ int annotate_sc(int argc,  char **argv)
   // Define and declare variables
   args_a_struct arguments;                               // Struct for handling command line parameters
   FILE *profiles_file;                                   // Profiles file descriptor
-  FILE *correlations_file;                               // Correlations file descriptor
-  FILE *xcorr_file, *annotation_o_file;                  // Output file descriptors
   int result;                                            // Result of any operation
   char* error_message;                                   // Error message to display in case of abnormal termination
   int nprofiles;                                         // Total number of profiles
-  int nclusters;                                         // Total number of clusters
-  double** xcorr;                                        // 2-dimensional matrix containing correlations between profiles
-  int i, j, index;                                       // Multi-purpose indexes
+  int i, index;                                          // Multi-purpose indexes
   profile_struct_annotation* profiles;                   // Array of profiles
-  map_struct map;                                        // Profile map
-  char categories[2][6] = {"NOVEL\0", "KNOWN\0"};        // Array for printing category
-  char strands[2][2] = {"+\0", "-\0"};                   // Array for printing strand
 
   // Initialize options with default values. Parse command line.
   // Exit if command is not well-formed.
-  arguments.annotation = ANNOTATION_CONDITION;
-  arguments.overlap_ftop = OVERLAP_FTOP;
-  arguments.overlap_ptof = OVERLAP_PTOF;
-  arguments.correlations = CORRELATIONS_CONDITION;
+  annotate_defaults(&arguments);
   if (parse_command_line_c(argc, argv, &error_message, &arguments) < 0) {
     fprintf(stderr, "%s\n", error_message);
     if ((strcmp(error_message, ANNOTATE_HELP_MSG) == 0) || (strcmp(error_message, VERSION_MSG) == 0))
@@ -47,10 +37,8 @@ int annotate_sc(int argc,  char **argv)
 
   // Allocate memory for profiles
   profiles = (profile_struct_annotation*) malloc(nprofiles * sizeof(profile_struct_annotation));
-  map_init(&map);
 
   // Open profiles file for reading and load them into memory
-  // Map the profiles if annotation is provided
   // Exit if profiles file does not exist, is not readable or is ill-formatted
   fprintf(stderr, "[LOG] LOADING PROFILES\n");
   index = 0;
@@ -59,37 +47,111 @@ int annotate_sc(int argc,  char **argv)
     fprintf(stderr, "%s - %s\n", ERR_PROFILE_F_NOT_READABLE, arguments.profiles_f_path);
     return(1);
   }
-  while((result = next_profile(profiles_file, &profiles[index++]) > 0)) {
-    if (arguments.annotation)
-      map_add_profile(&map, &profiles[index - 1]);
-  }
+  while((result = next_profile(profiles_file, &profiles[index++]) > 0));
   if (result < 0) {
     fprintf(stderr, "%s - %s\n", ERR_PROFILE_F_NOT_READABLE, arguments.profiles_f_path);
     return(1);
   }
+  fclose(profiles_file);
+
+  // Annotate and cluster the profiles
+  result = annotate_profiles(&arguments, profiles, nprofiles);
+
+  // Free profiles and exit
+  for (i = 0; i < nprofiles; i++)
+    free(profiles[i].profile);
+  free(profiles);
+  return(result);
+}
+
+
+/*
+ * annotate_defaults
+ *
+ * @see include/annotate/annotate.h
+ */
+void annotate_defaults(args_a_struct* arguments)
+{
+  arguments->annotation = ANNOTATION_CONDITION;
+  arguments->overlap_ftop = OVERLAP_FTOP;
+  arguments->overlap_ptof = OVERLAP_PTOF;
+  arguments->correlations = CORRELATIONS_CONDITION;
+  arguments->threads = THREADS;
+  arguments->prune = PRUNE_DISTANCE;
+  arguments->sparse = SPARSE_RADIUS;
+  arguments->metric = metric_find(DISTANCE_METRIC);
+  arguments->sweep = SWEEP_CONDITION;
+  arguments->clustering = CLUSTERING_METHOD;
+  arguments->cluster_cutoff = CLUSTER_CUTOFF;
+  arguments->dc_tolerance = DC_TOLERANCE;
+  arguments->kernel_truncation = KERNEL_TRUNCATION;
+}
+
+
+/*
+ * map_batch
+ *   Annotates a batch of streamed features through the profile map
+ */
+void map_batch(args_a_struct* arguments, feature_struct* features, long nfeatures, void* data)
+{
+  map_annotate_batch(arguments, (map_struct*) data, features, nfeatures);
+}
+
+/*
+ * annotate_profiles
+ *
+ * @see include/annotate/annotate.h
+ */
+int annotate_profiles(args_a_struct* arguments, profile_struct_annotation* profiles, int nprofiles)
+{
+  // Define and declare variables
+  FILE *correlations_file;                               // Correlations file descriptor
+  FILE *xcorr_file, *annotation_o_file;                  // Output file descriptors
+  int result;                                            // Result of any operation
+  int nclusters;                                         // Total number of clusters
+  double** xcorr;                                        // 2-dimensional matrix containing correlations between profiles
+  graph_struct* graph;                                   // Sparse graph containing distances between profiles
+  int i, j;                                              // Multi-purpose indexes
+  map_struct map;                                        // Profile map
+  char categories[2][6] = {"NOVEL\0", "KNOWN\0"};        // Array for printing category
+  char strands[2][2] = {"+\0", "-\0"};                   // Array for printing strand
+
+  // Map the profiles if annotation is provided and the sort-and-sweep pass is not used
+  map_init(&map);
+  if (arguments->annotation && !arguments->sweep)
+    for (i = 0; i < nprofiles; i++)
+      map_add_profile(&map, &profiles[i]);
+
 
   // Check if annotation files are provided
-  // Read annotation files and annotate profiles
-  if (arguments.annotation) {
-    feature_struct feature;
+  // Read annotation files in parallel and annotate profiles with the features in the order of the files
+  //   map   : features are annotated through the profile map in batches, as they are read
+  //   sweep : all the features are read and annotated at once with a sort-and-sweep pass
+  if (arguments->annotation) {
+    long nfeatures;
+    feature_struct* features;
+    int failed;
 
     fprintf(stderr, "[LOG] LOADING ANNOTATIONS\n");
-    for (i = 0; i < arguments.annotation; i++) {
-      FILE* annotation_i_file;
-
-      fprintf(stderr, "[LOG]   Reading %s\n", arguments.annotation_f_path[i]);
-      annotation_i_file = fopen(arguments.annotation_f_path[i], "r");
-      if (!annotation_i_file) {
-        fprintf(stderr, "%s - %s\n", ERR_ANNOTATION_F_NOT_READABLE, arguments.annotation_f_path[i]);
-        return(1);
-      }
-      while((result = next_feature(annotation_i_file, &feature) > 0))
-        map_annotate(&arguments, &map, feature.chromosome, feature.start, feature.end, feature.strand, feature.name);
-      if (result < 0) {
-        fprintf(stderr, "%s - %s\n", ERR_ANNOTATION_F_NOT_READABLE, arguments.annotation_f_path[i]);
-        return(1);
-      }
-      fclose(annotation_i_file);
+    for (i = 0; i < arguments->annotation; i++)
+      fprintf(stderr, "[LOG]   Reading %s\n", arguments->annotation_f_path[i]);
+    if (arguments->sweep)
+      nfeatures = load_features(arguments, &features, &failed);
+    else {
+      map_build(&map);
+      nfeatures = stream_features(arguments, map_batch, &map, &failed);
+    }
+    if (nfeatures < 0) {
+      if (nfeatures == -2)
+        fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+      else
+        fprintf(stderr, "%s - %s\n", ERR_ANNOTATION_F_NOT_READABLE, arguments->annotation_f_path[failed]);
+      return(1);
+    }
+    fprintf(stderr, "[LOG]   %ld features loaded\n", nfeatures);
+    if (arguments->sweep) {
+      sweep_annotate(arguments, profiles, nprofiles, features, nfeatures);
+      free(features);
     }
   }
 
@@ -97,61 +159,83 @@ int annotate_sc(int argc,  char **argv)
   map_destroy(&map);
 
   // Allocate memory for correlation
-  xcorr = (double**) malloc(nprofiles * sizeof(double*));
-  for (i = 0; i < nprofiles; i++) {
-    xcorr[i] = (double*) malloc(nprofiles * sizeof(double));
-    profiles[i].anscore = 0;
+  //   dense  : matrix with all the distances
+  //   sparse : graph with the distances <= radius. The rest are set to PRUNED_DISTANCE.
+  //            Not used by hierarchical clustering, which needs all the distances.
+  xcorr = NULL;
+  graph = NULL;
+  if (arguments->sparse > 0) {
+    if ((graph = graph_create(nprofiles, arguments->sparse, PRUNED_DISTANCE)) == NULL) {
+      fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+      return(1);
+    }
   }
+  else {
+    xcorr = (double**) malloc(nprofiles * sizeof(double*));
+    for (i = 0; i < nprofiles; i++)
+      xcorr[i] = (double*) malloc(nprofiles * sizeof(double));
+  }
+  for (i = 0; i < nprofiles; i++)
+    profiles[i].anscore = 0;
 
   // Read correlations file and store data
-  if (arguments.correlations) {
-    double score;
+  if (arguments->correlations) {
+    char metric_name[MAX_METRIC];
+    double score, prune, sparse;
 
     fprintf(stderr, "[LOG] LOADING DISTANCE SCORES\n");
-    correlations_file = fopen(arguments.correlations_f_path, "r");
-    if (!correlations_file) {
-      fprintf(stderr, "%s - %s\n", ERR_CORRELATIONS_F_NOT_READABLE, arguments.correlations_f_path);
+    correlations_file = fopen(arguments->correlations_f_path, "r");
+    if (!correlations_file || ((result = read_distances_header(correlations_file, metric_name, &prune, &sparse)) < 0)) {
+      fprintf(stderr, "%s - %s\n", ERR_CORRELATIONS_F_NOT_READABLE, arguments->correlations_f_path);
       return(1);
     }
+    if (result == 1)
+      fprintf(stderr, "        Distances calculated with %s, pruning distance %g and sparse radius %g\n", metric_name, prune, sparse);
     i = 0; j = i + 1;
-    while((result = next_correlation(correlations_file, &score) > 0)) {
-      xcorr[i][j] = score;
-      xcorr[j][i] = score;
+    while((result = next_correlation(correlations_file, &score)) > 0) {
+
+      // Distances that were not measured are taken as pruned
+      if (result == 2)
+        score = PRUNED_DISTANCE;
+      if (graph != NULL) {
+        if (graph_add(graph, i, j, score) < 0) {
+          fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+          return(1);
+        }
+      }
+      else {
+        xcorr[i][j] = score;
+        xcorr[j][i] = score;
+      }
       j++;
       if (j == nprofiles) {
-        xcorr[i][i] = 0;
+        if (graph == NULL) xcorr[i][i] = 0;
         i++;
         j = i + 1;
       }
     }
     if (result < 0) {
-      fprintf(stderr, "%s - %s\n", ERR_CORRELATIONS_F_NOT_READABLE, arguments.correlations_f_path);
+      fprintf(stderr, "%s - %s\n", ERR_CORRELATIONS_F_NOT_READABLE, arguments->correlations_f_path);
       return(1);
     }
 
-    xcorr[nprofiles - 1][nprofiles - 1] = 0.0f;
+    if (graph == NULL) xcorr[nprofiles - 1][nprofiles - 1] = 0.0f;
 
     fclose(correlations_file);
   }
 
-  // Calculate xcorrelations
+  // Calculate xcorrelations and print them as they are calculated
+  // Only pairs whose lower bound is not above the pruning distance are aligned.
+  // Pruned pairs are written as not measured, with the pruning distance they are known to be above.
   else {
-    fprintf(stderr, "[LOG] CALCULATING DISTANCE SCORES\n");
-    for (i = 0; i < (nprofiles - 1); i++) {
-      xcorr[i][i] = (double) 0.0f;
-      for (j = i + 1; j < nprofiles; j++) {
-        double corr = xdtw(&profiles[i], &profiles[j]);
-        if (corr < 0)
-          corr = 0;
-        xcorr[i][j] = 1 - corr;
-        xcorr[j][i] = 1 - corr;
-      }
-    }
-    xcorr[nprofiles - 1][nprofiles - 1] = 0.0f;
+    prune_struct* bounds;
+    features_struct* features;
+    metric_struct* metric;
+    long pruned = 0, abandoned = 0;
+    double ceiling;
 
-    // Print xcorrelations
     char *xcorr_file_name = malloc((MAX_PATH + strlen(CROSSCOR_SUFFIX) + 2) * sizeof(char));
-    strncpy(xcorr_file_name, arguments.output_f_path, MAX_PATH);
+    strncpy(xcorr_file_name, arguments->output_f_path, MAX_PATH);
     strcat(xcorr_file_name, PATH_SEPARATOR);
     strcat(xcorr_file_name, CROSSCOR_SUFFIX);
     xcorr_file = fopen(xcorr_file_name, "w");
@@ -162,8 +246,52 @@ int annotate_sc(int argc,  char **argv)
     }
     free(xcorr_file_name);
 
+    fprintf(stderr, "[LOG] CALCULATING DISTANCE SCORES\n");
+    bounds = (prune_struct*) malloc(nprofiles * sizeof(prune_struct));
+    metric = metric_get(arguments->metric);
+    write_distances_header(xcorr_file, metric->name, arguments->prune, arguments->sparse);
+    features = (features_struct*) malloc(nprofiles * sizeof(features_struct));
+    for (i = 0; i < nprofiles; i++) {
+      prune_build(&profiles[i], &bounds[i]);
+      metric_prepare(metric, &profiles[i], &features[i]);
+    }
+
+    // Distances beyond the ceiling are not stored: alignments are abandoned past it.
+    // Abandoned pairs are written as not measured, with the ceiling they are known to be above,
+    // unless the ceiling is 1: negative correlations are clipped, so their distance is exactly 1.
+    ceiling = MIN(arguments->prune, 1);
+    if (graph != NULL)
+      ceiling = MIN(ceiling, arguments->sparse);
+
     for (i = 0; i < (nprofiles - 1); i++) {
+      if (graph == NULL) xcorr[i][i] = (double) 0.0f;
       for (j = i + 1; j < nprofiles; j++) {
+        double corr, above = -1;
+        if ((arguments->prune < 1) && (prune_distance(&profiles[i], &bounds[i], &profiles[j], &bounds[j]) > arguments->prune)) {
+          corr = 1 - PRUNED_DISTANCE;
+          above = arguments->prune;
+          pruned++;
+        }
+        else {
+          corr = metric_correlation(metric, &profiles[i], &features[i], &profiles[j], &features[j], 1 - ceiling);
+          if ((corr == XDTW_ABANDONED) && (ceiling < 1)) {
+            above = ceiling;
+            abandoned++;
+          }
+        }
+        if (corr < 0)
+          corr = 0;
+        if (graph != NULL) {
+          if (graph_add(graph, i, j, 1 - corr) < 0) {
+            fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+            return(1);
+          }
+        }
+        else {
+          xcorr[i][j] = 1 - corr;
+          xcorr[j][i] = 1 - corr;
+        }
+
         if (profiles[i].strand == FWD_STRAND)
           fprintf(xcorr_file, "%s:%d-%d:+\t", profiles[i].chromosome, profiles[i].start, profiles[i].end);
         else
@@ -172,19 +300,92 @@ int annotate_sc(int argc,  char **argv)
           fprintf(xcorr_file, "%s:%d-%d:+\t", profiles[j].chromosome, profiles[j].start, profiles[j].end);
         else
           fprintf(xcorr_file, "%s:%d-%d:-\t", profiles[j].chromosome, profiles[j].start, profiles[j].end);
-        fprintf(xcorr_file, "%f\n", xcorr[i][j]);
+        if (above >= 0)
+          fprintf(xcorr_file, "%c%.17g\n", UNMEASURED_PREFIX, above);
+        else
+          fprintf(xcorr_file, "%.17g\n", 1 - corr);
       }
     }
+    if (graph == NULL) xcorr[nprofiles - 1][nprofiles - 1] = 0.0f;
+    free(bounds);
+    free(features);
+    fprintf(stderr, "        %ld pairs of profiles pruned\n", pruned);
+    fprintf(stderr, "        %ld pairs of profiles abandoned\n", abandoned);
 
     fclose(xcorr_file);
   }
 
+  if ((graph != NULL) && (graph_finalize(graph) < 0)) {
+    fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+    return(1);
+  }
+
+  // Hierarchical clustering
+  // The tree is branched at the given cutoff or at the cutoff with the best V-measure for the annotation
+  if (arguments->clustering == CLUSTERING_HIERARCHICAL) {
+    hcnode_struct* hc;
+    double* dist;
+    double cutoff;
+    FILE* clusters_file;
+
+    fprintf(stderr, "[LOG] PERFORMING HIERARCHICAL CLUSTERING\n");
+    dist = hc_condense_matrix(xcorr, nprofiles);
+    if ((dist == NULL) || ((hc = hc_cluster(dist, nprofiles, arguments->threads)) == NULL)) {
+      fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+      return(1);
+    }
+    free(dist);
+
+    // The V-measure curve of the cutoffs is written next to the tree
+    cutoff = arguments->cluster_cutoff;
+    if (cutoff < 0) {
+      FILE* vmeasure_file;
+      char *vmeasure_file_name = malloc((MAX_PATH + strlen(VMEASURE_SUFFIX) + 2) * sizeof(char));
+      strncpy(vmeasure_file_name, arguments->output_f_path, MAX_PATH);
+      strcat(vmeasure_file_name, PATH_SEPARATOR);
+      strcat(vmeasure_file_name, VMEASURE_SUFFIX);
+      vmeasure_file = fopen(vmeasure_file_name, "w");
+      if (!vmeasure_file) {
+        fprintf(stderr, "%s\n", ERR_OUTPUT_F_NOT_WRITABLE);
+        return (1);
+      }
+      free(vmeasure_file_name);
+      cutoff = hc_cutoff(hc, nprofiles, profiles, vmeasure_file);
+      fclose(vmeasure_file);
+      if (cutoff < 0) {
+        fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+        return(1);
+      }
+    }
+    fprintf(stderr, "        Branching tree at %f\n", cutoff);
+    nclusters = hc_branch(hc, nprofiles, profiles, cutoff);
+
+    char *clusters_file_name = malloc((MAX_PATH + strlen(CLUSTERS_SUFFIX) + 2) * sizeof(char));
+    strncpy(clusters_file_name, arguments->output_f_path, MAX_PATH);
+    strcat(clusters_file_name, PATH_SEPARATOR);
+    strcat(clusters_file_name, CLUSTERS_SUFFIX);
+    clusters_file = fopen(clusters_file_name, "w");
+    if (!clusters_file) {
+      fprintf(stderr, "%s\n", ERR_OUTPUT_F_NOT_WRITABLE);
+      return (1);
+    }
+    free(clusters_file_name);
+    hc_print(clusters_file, hc, nprofiles, profiles);
+    fclose(clusters_file);
+    free(hc);
+  }
+
   // Clustering by dpClust
-  fprintf(stderr, "[LOG] PERFORMING DP-CLUSTERING\n");
-  nclusters = dclustr(xcorr, nprofiles, profiles, 0.02, 1);
+  else {
+    fprintf(stderr, "[LOG] PERFORMING DP-CLUSTERING\n");
+    if (graph != NULL)
+      nclusters = dclustr_graph(graph, profiles, 0.02, 1, arguments->dc_tolerance, arguments->kernel_truncation, arguments->threads);
+    else
+      nclusters = dclustr(xcorr, nprofiles, profiles, 0.02, 1, arguments->dc_tolerance, arguments->kernel_truncation, arguments->threads);
+  }
 
   // Annotate unknown profiles if annotation is provided
-  if (arguments.annotation) {
+  if (arguments->annotation) {
     fprintf(stderr, "[LOG] ANNOTATING UNKNOWN PROFILES\n");
     cluster_annotate(nclusters, nprofiles, profiles);
   }
@@ -193,7 +394,7 @@ int annotate_sc(int argc,  char **argv)
   // Exit if output file is not writeable
   annotation_o_file = NULL;
   char *annotation_file_output_name = malloc((MAX_PATH + strlen(ANNOTATION_O_SUFFIX) + 2) * sizeof(char));
-  strncpy(annotation_file_output_name, arguments.output_f_path, MAX_PATH);
+  strncpy(annotation_file_output_name, arguments->output_f_path, MAX_PATH);
   strcat(annotation_file_output_name, PATH_SEPARATOR);
   strcat(annotation_file_output_name, ANNOTATION_O_SUFFIX);
   annotation_o_file = fopen(annotation_file_output_name, "w");
@@ -209,14 +410,14 @@ int annotate_sc(int argc,  char **argv)
   }
 
   // Close descriptors, free structures and exit
-  for (i = 0; i < nprofiles; i++)
-    free(profiles[i].profile);
-  free(profiles);
-  for (i = 0; i < nprofiles; i++)
-    free(xcorr[i]);
-  free(xcorr);
-  fclose(profiles_file);
-  if (arguments.annotation)
+  if (graph != NULL)
+    graph_destroy(graph);
+  else {
+    for (i = 0; i < nprofiles; i++)
+      free(xcorr[i]);
+    free(xcorr);
+  }
+  if (arguments->annotation)
     fclose(annotation_o_file);
   return(0);
 }
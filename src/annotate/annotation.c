@@ -77,73 +77,56 @@ void xcorr_annotate(annotation_struct** xcorr, int nprofiles, profile_struct_ann
  */
 void cluster_annotate(int nclusters, int nprofiles, profile_struct_annotation* profiles)
 {
-  int i, j, max_profiles_per_cluster, nclasses;
-  int* profiles_per_cluster;
-  int** profiles_index;
-  StrMap *sm;
-  char buffer[MAX_FEATURE];
-
-  // Initialize data structures
-  max_profiles_per_cluster = nprofiles - (nclusters - 1);
-  profiles_per_cluster = (int*) malloc(nclusters * sizeof(int));
-  profiles_index = (int**) malloc(nclusters * sizeof(int*));
-  for (i = 0; i < nclusters; i++) {
-    profiles_per_cluster[i] = 0;
-    profiles_index[i] = (int*) malloc(max_profiles_per_cluster * sizeof(int));
-    for (j = 0; j < max_profiles_per_cluster; j++) profiles_index[i][j] = -1;
-  }
-  sm = sm_new(nprofiles);
-  
-  // Fill data structures
-  nclasses = 0;
-  for (i = 0; i < nprofiles; i++) {
-    int cindex = profiles[i].cluster - 1;
-    j = 0;
-
-    profiles_per_cluster[cindex]++;
-    while (profiles_index[cindex][j] >= 0) j++;
-    profiles_index[cindex][j] = i;
-
-    if (sm_get(sm, profiles[i].annotation, buffer, MAX_FEATURE) == 0) {
-      sprintf(buffer, "%d", nclasses);
-      sm_put(sm, profiles[i].annotation, buffer);
-      nclasses++;
-    }
-  }
+  int i, j;
+  int *offset, *members, *class, *votes;
+  chrdict_struct classes;
+
+  // Intern the classes of the annotated profiles. Unknown profiles have class -1.
+  chrdict_init(&classes);
+  class = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  for (i = 0; i < nprofiles; i++)
+    class[i] = (strcmp(profiles[i].annotation, "unknown") != 0) ? chrdict_intern(&classes, profiles[i].annotation) : -1;
+
+  // Members of cluster c are members[offset[c]] to members[offset[c + 1] - 1], in ascending order (counting sort)
+  offset = (int*) calloc(nclusters + 2, sizeof(int));
+  members = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  for (i = 0; i < nprofiles; i++)
+    if ((profiles[i].cluster >= 1) && (profiles[i].cluster <= nclusters))
+      offset[profiles[i].cluster + 1]++;
+  for (i = 1; i <= nclusters + 1; i++)
+    offset[i] += offset[i - 1];
+  for (i = 0; i < nprofiles; i++)
+    if ((profiles[i].cluster >= 1) && (profiles[i].cluster <= nclusters))
+      members[offset[profiles[i].cluster]++] = i;
 
   // Annotate unknown profiles in a cluster with the majority class
+  // On ties, the class that reached the highest number of votes first wins
+  votes = (int*) calloc(MAX(classes.size, 1), sizeof(int));
   for (i = 0; i < nclusters; i++) {
-    int max = 0;
-    char class[MAX_FEATURE] = "unknown";
-    int* profiles_per_class = (int*) malloc(sizeof(int) * nclasses);
-
-    for (j = 0; j < nclasses; j++) profiles_per_class[j] = 0;
-
-    for (j = 0; j < profiles_per_cluster[i]; j++) {
-      int pindex = profiles_index[i][j];
-      if (strcmp(profiles[pindex].annotation, "unknown") != 0) {
-        if (sm_get(sm, profiles[pindex].annotation, buffer, MAX_FEATURE) != 0) profiles_per_class[atoi(buffer)]++;
-        if (max < profiles_per_class[atoi(buffer)]) {
-          max = profiles_per_class[atoi(buffer)];
-          strncpy(class, profiles[pindex].annotation, MAX_FEATURE);
-        }
+    int first = offset[i], last = offset[i + 1];
+    int max = 0, best = -1;
+
+    for (j = first; j < last; j++) {
+      int c = class[members[j]];
+      if ((c >= 0) && (max < ++votes[c])) {
+        max = votes[c];
+        best = c;
       }
     }
 
-    for (j = 0; j < profiles_per_cluster[i]; j++) {
-      if (strcmp(class, "unknown") != 0) {
-        int pindex = profiles_index[i][j];
-        if (strcmp(profiles[pindex].annotation, "unknown") == 0)
-          strncpy(profiles[pindex].annotation, class, MAX_FEATURE);
-      }
+    for (j = first; j < last; j++) {
+      int pindex = members[j];
+      if (class[pindex] >= 0)
+        votes[class[pindex]] = 0;
+      else if (best >= 0)
+        strcpy(profiles[pindex].annotation, chrdict_name(&classes, best));
     }
-
-    free(profiles_per_class);
   }
 
   // Free data structures
-  for (i = 0; i < nclusters; i++) free(profiles_index[i]);
-  free(profiles_index);
-  free(profiles_per_cluster);
-  sm_delete(sm);
+  free(votes);
+  free(members);
+  free(offset);
+  free(class);
+  chrdict_destroy(&classes);
 }
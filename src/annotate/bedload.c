@@ -0,0 +1,254 @@
+#include <annotate/bedload.h>
+
+/*
+ * Bytes [begin, end) of an annotation file parsed by a task.
+ * A chunk holds the lines that start in its range, so every line is parsed by exactly one chunk.
+ */
+typedef struct {
+  int file;
+  long begin;
+  long end;
+  feature_struct* features;
+  long nfeatures;
+  int status;
+} bedchunk_struct;
+
+/*
+ * Struct shared by the loading tasks
+ */
+typedef struct {
+  args_a_struct* arguments;
+  bedchunk_struct* chunks;
+} bedload_struct;
+
+/*
+ * cmpbedcost
+ *   Comparison function to sort chunks by descending size, so the largest ones are scheduled first
+ */
+int cmpbedcost(const void *x, const void *y)
+{
+  const bedchunk_struct* xx = (const bedchunk_struct*) x;
+  const bedchunk_struct* yy = (const bedchunk_struct*) y;
+
+  if ((xx->end - xx->begin) > (yy->end - yy->begin)) return -1;
+  if ((xx->end - xx->begin) < (yy->end - yy->begin)) return 1;
+  if (xx->file != yy->file) return (xx->file < yy->file) ? -1 : 1;
+  return (xx->begin < yy->begin) ? -1 : (xx->begin > yy->begin);
+}
+
+/*
+ * cmpbedorder
+ *   Comparison function to sort chunks in the order of the files and of the lines within them
+ */
+int cmpbedorder(const void *x, const void *y)
+{
+  const bedchunk_struct* xx = (const bedchunk_struct*) x;
+  const bedchunk_struct* yy = (const bedchunk_struct*) y;
+
+  if (xx->file != yy->file) return (xx->file < yy->file) ? -1 : 1;
+  return (xx->begin < yy->begin) ? -1 : (xx->begin > yy->begin);
+}
+
+/*
+ * bedload_task
+ *   Parses the lines of a chunk
+ *   status is 0 if success, -1 if the file is not readable or ill-formatted and -2 if there is not enough memory
+ */
+void bedload_task(int index, int thread, void* data)
+{
+  bedload_struct* load = (bedload_struct*) data;
+  bedchunk_struct* chunk = &load->chunks[index];
+  FILE* fp;
+  char* line = NULL;
+  size_t len = 0;
+  ssize_t read;
+  long position, capacity;
+  int c;
+
+  chunk->features = NULL;
+  chunk->nfeatures = 0;
+  chunk->status = 0;
+  if ((fp = fopen(load->arguments->annotation_f_path[chunk->file], "r")) == NULL) {
+    chunk->status = -1;
+    return;
+  }
+
+  // Move to the first line that starts in the chunk
+  position = chunk->begin;
+  if (position > 0) {
+    fseek(fp, position - 1, SEEK_SET);
+    while (((c = fgetc(fp)) != EOF) && (c != '\n'))
+      position++;
+  }
+
+  capacity = 0;
+  while ((position < chunk->end) && ((read = getline(&line, &len, fp)) >= 0)) {
+    position += read;
+    if (line[0] == '\n')
+      continue;
+    if (chunk->nfeatures == capacity) {
+      feature_struct* tmp_features;
+      capacity = (capacity == 0) ? BED_CHUNK_FEATURES : 2 * capacity;
+      if ((tmp_features = (feature_struct*) realloc(chunk->features, capacity * sizeof(feature_struct))) == NULL) {
+        chunk->status = -2;
+        break;
+      }
+      chunk->features = tmp_features;
+    }
+    if (parse_feature(line, &chunk->features[chunk->nfeatures]) < 0) {
+      chunk->status = -1;
+      break;
+    }
+    chunk->nfeatures++;
+  }
+
+  free(line);
+  fclose(fp);
+}
+
+/*
+ * split_chunks
+ *   Splits the annotation files into chunks of BED_CHUNK_SIZE bytes, in the order of the files and of the lines within them.
+ *   Files that can not be sized, such as pipes, are read by a single chunk.
+ *
+ * @return
+ *   The number of chunks. -1 if an annotation file is not readable, and its index is stored in failed.
+ *   -2 if there is not enough memory.
+ */
+int split_chunks(args_a_struct* arguments, bedchunk_struct** chunks, int* failed)
+{
+  int nchunks, i, j;
+
+  nchunks = 0;
+  *chunks = NULL;
+  for (i = 0; i < arguments->annotation; i++) {
+    FILE* fp;
+    long size;
+    bedchunk_struct* tmp_chunks;
+
+    if ((fp = fopen(arguments->annotation_f_path[i], "r")) == NULL) {
+      free(*chunks);
+      *failed = i;
+      return(-1);
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fclose(fp);
+
+    if ((tmp_chunks = (bedchunk_struct*) realloc(*chunks, (nchunks + size / BED_CHUNK_SIZE + 1) * sizeof(bedchunk_struct))) == NULL) {
+      free(*chunks);
+      return(-2);
+    }
+    *chunks = tmp_chunks;
+
+    if (size < 0) {
+      (*chunks)[nchunks].file = i;
+      (*chunks)[nchunks].begin = 0;
+      (*chunks)[nchunks].end = LONG_MAX;
+      nchunks++;
+      continue;
+    }
+    for (j = 0; (j == 0) || ((long) j * BED_CHUNK_SIZE < size); j++) {
+      (*chunks)[nchunks].file = i;
+      (*chunks)[nchunks].begin = (long) j * BED_CHUNK_SIZE;
+      (*chunks)[nchunks].end = MIN((long) (j + 1) * BED_CHUNK_SIZE, size);
+      nchunks++;
+    }
+  }
+
+  return(nchunks);
+}
+
+/*
+ * load_features
+ *
+ * @see include/annotate/bedload.h
+ */
+long load_features(args_a_struct* arguments, feature_struct** features, int* failed)
+{
+  bedload_struct load;
+  bedchunk_struct* chunks;
+  int nchunks, i;
+  long nfeatures;
+
+  // Split the files into chunks
+  if ((nchunks = split_chunks(arguments, &chunks, failed)) < 0)
+    return(nchunks);
+
+  // Parse the chunks, largest first
+  qsort(chunks, nchunks, sizeof(bedchunk_struct), cmpbedcost);
+  load.arguments = arguments;
+  load.chunks = chunks;
+  parallel_for(nchunks, arguments->threads, 1, bedload_task, &load);
+  qsort(chunks, nchunks, sizeof(bedchunk_struct), cmpbedorder);
+
+  // Merge the chunks in order. The first failure in order is reported.
+  nfeatures = 0;
+  for (i = 0; i < nchunks; i++) {
+    if (chunks[i].status < 0) {
+      nfeatures = chunks[i].status;
+      *failed = chunks[i].file;
+      break;
+    }
+    nfeatures += chunks[i].nfeatures;
+  }
+  if (nfeatures >= 0) {
+    if ((*features = (feature_struct*) malloc(MAX(nfeatures, 1) * sizeof(feature_struct))) == NULL)
+      nfeatures = -2;
+    else {
+      long offset = 0;
+      for (i = 0; i < nchunks; i++) {
+        memcpy(*features + offset, chunks[i].features, chunks[i].nfeatures * sizeof(feature_struct));
+        offset += chunks[i].nfeatures;
+      }
+    }
+  }
+
+  for (i = 0; i < nchunks; i++)
+    free(chunks[i].features);
+  free(chunks);
+
+  return(nfeatures);
+}
+
+/*
+ * stream_features
+ *
+ * @see include/annotate/bedload.h
+ */
+long stream_features(args_a_struct* arguments, bedload_batch batch, void* data, int* failed)
+{
+  bedload_struct load;
+  bedchunk_struct* chunks;
+  int nchunks, window, first, i;
+  long nfeatures;
+
+  // Split the files into chunks, already in order
+  if ((nchunks = split_chunks(arguments, &chunks, failed)) < 0)
+    return(nchunks);
+
+  // Parse a window of one chunk per thread at a time and hand its features over in order
+  window = MAX(arguments->threads, 1);
+  load.arguments = arguments;
+  nfeatures = 0;
+  for (first = 0; (nfeatures >= 0) && (first < nchunks); first += window) {
+    int n = MIN(window, nchunks - first);
+
+    load.chunks = chunks + first;
+    parallel_for(n, arguments->threads, 1, bedload_task, &load);
+    for (i = first; i < first + n; i++) {
+      if ((nfeatures >= 0) && (chunks[i].status < 0)) {
+        nfeatures = chunks[i].status;
+        *failed = chunks[i].file;
+      }
+      if (nfeatures >= 0) {
+        batch(arguments, chunks[i].features, chunks[i].nfeatures, data);
+        nfeatures += chunks[i].nfeatures;
+      }
+      free(chunks[i].features);
+    }
+  }
+  free(chunks);
+
+  return(nfeatures);
+}
@@ -1,13 +1,5 @@
 #include <annotate/dclust.h>
 
-int cmpd(const void *x, const void *y)
-{
-  double xx = *(double*)x, yy = *(double*)y;
-  if (xx < yy) return -1;
-  if (xx > yy) return  1;
-  return 0;
-}
-
 int cmpi(const void *x, const void *y)
 {
   int xx = *(int*)x, yy = *(int*)y;
@@ -28,148 +20,397 @@ int cmpsm (const void *x, const void *y)
 
 
 /*
- * dcoptimize
+ * potentials_entropy
+ *   Entropy of a set of potentials. DBL_MAX if any potential is 0.
+ */
+double potentials_entropy(double* potentials, int n)
+{
+  double z, h;
+  int i;
+
+  // Calculate Z (normalization factor)
+  //   sigma is not valid if the potential of any point vanishes
+  z = 0;
+  for (i = 0; i < n; i++) {
+    if (potentials[i] <= 0) return(DBL_MAX);
+    z += potentials[i];
+  }
+
+  // Calculate H (entropy)
+  h = 0;
+  for (i = 0; i < n; i++) {
+    double a = potentials[i] / z;
+    h += a * log(a);
+  }
+
+  return(-h);
+}
+
+/*
+ * entropy
+ *   Entropy of the potentials of the points for a given impact factor (sigma),
+ *   approximated from their binned distances
+ */
+double entropy(int* histogram, int n, double width, double sigma, double* potentials, int nthreads)
+{
+  kernel_density_binned(histogram, n, width, DC_BINS, sigma, potentials, nthreads);
+  return(potentials_entropy(potentials, n));
+}
+
+/*
+ * entropy_exact
+ *   Entropy of the potentials of the points for a given impact factor (sigma),
+ *   calculated from their distances
+ */
+double entropy_exact(double** dist, graph_struct* graph, int* index, int* position, int n, double sigma, double* potentials, int nthreads)
+{
+  if (graph == NULL)
+    kernel_density(dist, index, n, sigma, 1, 0, potentials, nthreads);
+  else
+    kernel_density_graph(graph, index, position, n, sigma, 1, 0, potentials, nthreads);
+  return(potentials_entropy(potentials, n));
+}
+
+/*
+ * grid_sigma
+ *   Value k of the grid of sigma between lower and upper in increments of tolerance.
+ *   Increments are taken in single precision, as the exhaustive scan of sigma did.
+ */
+double grid_sigma(double lower, double tolerance, int k)
+{
+  return(lower + k * (double) (float) tolerance);
+}
+
+/*
+ * dcentropy
+ *   Finds the impact factor (sigma) between lower and upper that minimizes the entropy
+ *   of the potentials of a set of points.
  *
- * @see include/annotate/dclust.h
+ *   Distances are binned per point once, so that each evaluation of the entropy costs
+ *   one kernel evaluation per bin instead of one per pair. The minimum is bracketed by
+ *   a coarse scan of DC_SCAN values of sigma and narrowed by golden-section search.
+ *   The final step is taken on the exact distances: starting from the grid value of sigma
+ *   closest to the binned minimum, the grid of increments of tolerance is walked down to
+ *   its nearest local minimum of the entropy.
+ *
+ * @arg double** dist
+ *   Distance/dissimilarity matrix. NULL if graph is provided.
+ * @arg graph_struct* graph
+ *   Sparse distance graph. NULL if dist is provided.
+ * @arg int* index
+ *   Indexes of the points in the set, in ascending order. NULL for all the points.
+ * @arg int* position
+ *   Position in index of every point, -1 if it is not in the set. Only used with graph.
+ * @arg int n
+ *   Number of points in the set
+ * @arg double lower
+ *   Lower boundary for sigma
+ * @arg double upper
+ *   Upper boundary for sigma
+ * @arg double tolerance
+ *   Increment of sigma of the grid where the minimum is refined
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   The value of sigma with minimum entropy
  */
-double dcoptimize(double** dist, int n, double* max)
+double dcentropy(double** dist, graph_struct* graph, int* index, int* position, int n, double lower, double upper, double tolerance, int nthreads)
 {
-  double dc, z, h, hmin, lower, upper, sigma;
-  double* allds;
-  int i, j, counter;
+  const double ratio = (sqrt(5.0) - 1) / 2;
+  double a, b, c, d, fc, fd, step, h, hmin, width;
+  int i, imin, k, kstart, kmax;
+  int* histogram;
   double* potentials;
 
-  // Initialize variables
+  if (lower > upper) return(0.0);
+
+  // Bin the distances that can contribute to the potentials
+  width = (DC_KERNEL_RANGE * upper) / DC_BINS;
+  if (graph == NULL)
+    histogram = density_histogram(dist, index, n, width, DC_BINS, nthreads);
+  else
+    histogram = density_histogram_graph(graph, index, position, n, width, DC_BINS, nthreads);
   potentials = (double*) malloc(n * sizeof(double));
-  allds = (double*) malloc(sizeof(double) * (n * (n - 1) / 2));
+
+  // Bracket the minimum
+  step = (upper - lower) / (DC_SCAN - 1);
   hmin = DBL_MAX;
-  dc = 0.0;
+  imin = 0;
+  for (i = 0; i < DC_SCAN; i++) {
+    h = entropy(histogram, n, width, lower + i * step, potentials, nthreads);
+    if (h < hmin) {
+      hmin = h;
+      imin = i;
+    }
+  }
+  a = lower + ((imin > 0) ? imin - 1 : 0) * step;
+  b = lower + ((imin < DC_SCAN - 1) ? imin + 1 : DC_SCAN - 1) * step;
+
+  // Golden-section search
+  c = b - ratio * (b - a);
+  d = a + ratio * (b - a);
+  fc = entropy(histogram, n, width, c, potentials, nthreads);
+  fd = entropy(histogram, n, width, d, potentials, nthreads);
+  while ((b - a) > tolerance) {
+    if (fc < fd) {
+      b = d;
+      d = c;
+      fd = fc;
+      c = b - ratio * (b - a);
+      fc = entropy(histogram, n, width, c, potentials, nthreads);
+    }
+    else {
+      a = c;
+      c = d;
+      fc = fd;
+      d = a + ratio * (b - a);
+      fd = entropy(histogram, n, width, d, potentials, nthreads);
+    }
+  }
 
-  // Convert dissimilarity matrix into a vector
-  // Sort dissimilarity vector ascendently
-  counter = 0;
-  for (i = 0; i < n; i++) {
-    for(j = i + 1; j < n; j++) {
-      allds[counter] = dist[i][j];
-      counter++;
+  // Refine on the exact distances over the grid of sigma
+  //   Lower values are taken on ties
+  kmax = (int) floor((upper - lower) / (float) tolerance);
+  if ((kmax > 0) && (grid_sigma(lower, tolerance, kmax) > upper))
+    kmax--;
+  kmax = MAX(kmax, 0);
+  k = (int) floor(((a + b) / 2 - lower) / tolerance + 0.5);
+  k = MAX(0, MIN(k, kmax));
+  kstart = k;
+  hmin = entropy_exact(dist, graph, index, position, n, grid_sigma(lower, tolerance, k), potentials, nthreads);
+  while ((hmin < DBL_MAX) && (k > 0) &&
+         ((h = entropy_exact(dist, graph, index, position, n, grid_sigma(lower, tolerance, k - 1), potentials, nthreads)) <= hmin)) {
+    hmin = h;
+    k--;
+  }
+  if (k == kstart) {
+    while ((k < kmax) &&
+           ((h = entropy_exact(dist, graph, index, position, n, grid_sigma(lower, tolerance, k + 1), potentials, nthreads)) < hmin)) {
+      hmin = h;
+      k++;
     }
   }
-  qsort(allds, n * (n - 1) / 2, sizeof(double), cmpd);
-  *max = allds[counter - 1];
+
+  free(histogram);
+  free(potentials);
+
+  return(grid_sigma(lower, tolerance, k));
+}
+
+/*
+ * dcoptimize
+ *
+ * @see include/annotate/dclust.h
+ */
+double dcoptimize(double** dist, int n, double* max, double tolerance, int nthreads)
+{
+  double lower, upper;
 
   // Calculate lower and upper boundaries for sigma (impact factor)
   //   lower : minimum distance > 0
   //   upper : distance at 10 percentile
-  counter = 0;
-  while(allds[counter] == 0) counter++;
-  lower = allds[counter];
-  upper = gsl_stats_quantile_from_sorted_data(allds, 1, (n * (n - 1) / 2), 0.10);
-
-  // Calculate entropy for values of sigma between lower and upper in increments of 0.005
-  for (sigma = lower; sigma <= upper; sigma += 0.005f) {
-
-    // Calculate potential for each point
-    for(i = 0; i < n; i++) {
-      potentials[i] = 0.0f;
-      for(j = 0; j < n; j++) {
-        double sq = (dist[i][j] / sigma) * (dist[i][j] / sigma);
-        double expsq = exp(-sq);
-        if (j != i) potentials[i] += expsq;
-      }
-    }
+  upper = quantile_pairs(dist, n, 0.10, &lower, max);
 
-    // Calculate Z (normalization factor)
-    z = 0;
-    for (i = 0; i < n; i++)
-      z += potentials[i];
+  return((3/sqrt(2)) * dcentropy(dist, NULL, NULL, NULL, n, lower, upper, tolerance, nthreads));
+}
 
-    // Calculate H (entropy)
-    h = 0;
-    for (i = 0; i < n; i++) {
-      double a = potentials[i] / z;
-      double b = log(a);
-      h += a*b;
+/*
+ * dcoptimize_graph
+ *
+ * @see include/annotate/dclust.h
+ */
+double dcoptimize_graph(graph_struct* graph, double* max, double tolerance, int nthreads)
+{
+  double lower, upper;
+  distribution_struct* distribution;
+
+  // Calculate lower and upper boundaries for sigma (impact factor)
+  //   lower : minimum distance > 0
+  //   upper : distance at 10 percentile
+  distribution = distribution_create_graph(graph);
+  lower = distribution_min_nonzero(distribution);
+  upper = distribution_quantile(distribution, 0.10);
+  *max = distribution_max(distribution);
+  distribution_destroy(distribution);
+
+  return((3/sqrt(2)) * dcentropy(NULL, graph, NULL, NULL, graph->n, lower, upper, tolerance, nthreads));
+}
+
+/*
+ * Struct shared by the dpClust tasks
+ */
+typedef struct {
+  double** dist;
+  graph_struct* graph;
+  int n;
+  double dc;
+  double maxd;
+  double* rho;
+  double* delta;
+  int* nhigher;
+  int* cl;
+  int* border;
+  nnlist_struct* nn;
+} dclust_struct;
+
+/*
+ * delta_task
+ *   Calculates DELTA for point i and its nearest neighbour of higher density
+ *     DELTA[i] = minimum {dist(i,j) if RHO[j] > RHO[i]}
+ *   Ties in distance are broken by the lowest index. Sorted neighbour lists are
+ *   scanned first and the full row is only scanned if no neighbour of higher
+ *   density lies within the radius of the lists.
+ */
+void delta_task(int i, int thread, void* data)
+{
+  dclust_struct* d = (dclust_struct*) data;
+  double* rho = d->rho;
+  double mindist;
+  long k;
+  int j, minidx;
+
+  // Scan sorted neighbours
+  for (k = d->nn->offset[i]; k < d->nn->offset[i + 1]; k++) {
+    neighbour_struct nb = d->nn->neighbours[k];
+    if (rho[i] < rho[nb.index]) {
+      d->delta[i] = nb.distance;
+      d->nhigher[i] = nb.index;
+      return;
     }
-    h = h * (-1);
+  }
 
-    // Store dc and hmin
-    if (h < hmin) {
-      hmin = h;
-      dc = sigma;
+  // Scan full row
+  mindist = d->maxd;
+  minidx = -1;
+  if (d->graph == NULL) {
+    for (j = 0; j < d->n; j++) {
+      if ((rho[i] < rho[j]) && ((d->dist[i][j] < mindist) || ((d->dist[i][j] == mindist) && (minidx < 0)))) {
+        mindist = d->dist[i][j];
+        minidx = j;
+      }
     }
   }
+  else {
+    graph_struct* g = d->graph;
+    for (k = g->offset[i]; k < g->offset[i + 1]; k++) {
+      j = g->index[k];
+      if ((rho[i] < rho[j]) && ((g->distance[k] < mindist) || ((g->distance[k] == mindist) && ((minidx < 0) || (j < minidx))))) {
+        mindist = g->distance[k];
+        minidx = j;
+      }
+    }
 
-  free(potentials);
-  free(allds);
+    // Lowest point of higher density that is not stored, at the sentinel distance
+    if ((g->sentinel < mindist) || ((g->sentinel == mindist) && (minidx != 0))) {
+      k = g->offset[i];
+      for (j = 0; (j < d->n) && ((minidx < 0) || (g->sentinel < mindist) || (j < minidx)); j++) {
+        while ((k < g->offset[i + 1]) && (g->index[k] < j)) k++;
+        if ((j != i) && (rho[i] < rho[j]) && ((k == g->offset[i + 1]) || (g->index[k] != j))) {
+          mindist = g->sentinel;
+          minidx = j;
+          break;
+        }
+      }
+    }
+  }
+  d->delta[i] = mindist;
+  d->nhigher[i] = minidx;
+}
 
-  return((3/sqrt(2)) * dc);
+/*
+ * border_task
+ *   Checks if point i has a neighbour from another cluster at a distance <= dc
+ */
+void border_task(int i, int thread, void* data)
+{
+  dclust_struct* d = (dclust_struct*) data;
+  long k;
+
+  d->border[i] = 0;
+  for (k = d->nn->offset[i]; (k < d->nn->offset[i + 1]) && (d->nn->neighbours[k].distance <= d->dc); k++) {
+    if (d->cl[d->nn->neighbours[k].index] != d->cl[i]) {
+      d->border[i] = 1;
+      return;
+    }
+  }
 }
 
 /*
- * dclust
+ * dpclust
+ *   Calculates a clustering by fast search and find of density peaks on either a
+ *   distance matrix or a sparse distance graph
  *
  * @see include/annotate/dclust.h
  */
-int dclust(double** dist, int n, profile_struct_annotation* profiles, double cutoff, int gaussian)
+int dpclust(double** dist, graph_struct* graph, int n, profile_struct_annotation* profiles, double cutoff, int gaussian, double tolerance, double truncation, int nthreads)
 {
-  int *cl, *halo;
+  int *cl, *halo, *nhigher, *border;
   double *rho, *delta, *sortrho, *sortdelta, *bord_rho;
-  int i, j, nclust;
+  int i, nclust;
   double dc, maxd, rhothreshold, deltathreshold;
   rho_struct *strho;
+  dclust_struct d;
 
   // Initialize structures
   cl = (int*) malloc(sizeof(int) * n);
   halo = (int*) malloc(sizeof(int) * n); 
+  nhigher = (int*) malloc(sizeof(int) * n);
+  border = (int*) malloc(sizeof(int) * n);
   rho = (double*) malloc(sizeof(double) * n);
   delta = (double*) malloc(sizeof(double) * n);
   sortrho = (double*) malloc(sizeof(double) * n);
   sortdelta = (double*) malloc(sizeof(double) * n);
   strho = (rho_struct*) malloc(sizeof(rho_struct) * n);
-  for (i = 0; i < n; i++) rho[i] = 0.0;
 
   // Calculate optimal dc
   // Calculate maximum distance
-  dc = dcoptimize(dist, n, &maxd);
+  if (graph == NULL)
+    dc = dcoptimize(dist, n, &maxd, tolerance, nthreads);
+  else
+    dc = dcoptimize_graph(graph, &maxd, tolerance, nthreads);
   if (cutoff > 0)
     dc = cutoff;
   fprintf(stderr, "        Distance cutoff is %f\n", dc);
 
-  // Calculate RHO[i] per point using gaussian kernel
-  //   RHO[i] = sum {exp(-(dist(i,j)/dc)^2)}
-  if (gaussian) {
-    for(i = 0; i < n; i++) {
-      for(j = i + 1; j < n; j++) {
-        double sq = -(dist[i][j] / (double)dc) * (dist[i][j] / (double)dc);
-        double expsq = exp(sq);
-        rho[i] += expsq;
-        rho[j] += expsq;
-      }
-    }
+  // Build neighbour lists sorted by distance
+  d.dist = dist;
+  d.graph = graph;
+  d.n = n;
+  d.dc = dc;
+  d.maxd = maxd;
+  d.rho = rho;
+  d.delta = delta;
+  d.nhigher = nhigher;
+  d.cl = cl;
+  d.border = border;
+  if (graph == NULL)
+    d.nn = nn_build(dist, n, NN_RADIUS * dc, nthreads);
+  else
+    d.nn = nn_build_graph(graph, NN_RADIUS * dc, nthreads);
+  if (d.nn == NULL) {
+    fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+    free(cl);
+    free(halo);
+    free(nhigher);
+    free(border);
+    free(rho);
+    free(sortrho);
+    free(delta);
+    free(sortdelta);
+    free(strho);
+    return(-1);
   }
 
   // Calculate RHO per point
-  //   RHO[i] = number of points j that satisfy dist(i,j) < dc
-  if (!gaussian) {
-    for(i = 0; i < n; i++) {
-      for(j = i + 1; j < n; j++) {
-        if(dist[i][j] < dc) {
-          rho[i]++;
-          rho[j]++;
-        }
-      }
-    }
-  }
+  if (graph == NULL)
+    kernel_density(dist, NULL, n, dc, gaussian, truncation, rho, nthreads);
+  else
+    kernel_density_graph(graph, NULL, NULL, n, dc, gaussian, truncation, rho, nthreads);
 
-  // Calculate DELTA per point
+  // Calculate DELTA and nearest neighbour of higher density per point
   //   DELTA[i] = minimum {dist(i,j) if RHO[j] > RHO[i]}
-  for (i = 0; i < n; i++) {
-    delta[i] = maxd;
-    for (j = 0; j < n; j++) {
-      if ((j != i) && (rho[i] < rho[j]) && (delta[i] > dist[i][j]))
-        delta[i] = dist[i][j];
-    }
-  }
+  parallel_for(n, nthreads, 64, delta_task, &d);
 
   // Calculation of RHO and DELTA threshold
   //   deltathreshold = 3rd quartile
@@ -178,10 +419,8 @@ int dclust(double** dist, int n, profile_struct_annotation* profiles, double cut
     sortrho[i] = rho[i];
     sortdelta[i] = delta[i];
   }
-  qsort(sortrho, n, sizeof(double), cmpd);
-  qsort(sortdelta, n, sizeof(double), cmpd);
-  rhothreshold = gsl_stats_quantile_from_sorted_data(sortrho, 1, n, 0.25);
-  deltathreshold = gsl_stats_quantile_from_sorted_data(sortdelta, 1, n, 0.75);
+  rhothreshold = quantile_select(sortrho, n, 0.25);
+  deltathreshold = quantile_select(sortdelta, n, 0.75);
   fprintf(stderr, "        Rho cutoff is %f\n", rhothreshold);
   fprintf(stderr, "        Delta cutoff is %f\n", deltathreshold);
 
@@ -208,38 +447,19 @@ int dclust(double** dist, int n, profile_struct_annotation* profiles, double cut
   // Point is assigned to the same cluster as its nearest neighbor of higher density
   for (i = 0; i < n; i++) {
     int idxi = strho[i].index;
-    if (cl[idxi] == 0) {
-      double mindist = maxd;
-      int minidx = n;
-      for (j = 0; j < i; j++) {
-        int idxj = strho[j].index;
-        if ((rho[idxi] < rho[idxj]) && (dist[idxi][idxj] < mindist)) {
-          cl[idxi] = cl[idxj];
-          mindist = dist[idxi][idxj];
-          minidx = idxj;
-        }
-        else if ((rho[idxi] < rho[idxj]) && (dist[idxi][idxj] == mindist) && (idxj < minidx)) {
-          cl[idxi] = cl[idxj];
-          mindist = dist[idxi][idxj];
-          minidx = idxj;
-        }
-      }
-    }
+    if ((cl[idxi] == 0) && (nhigher[idxi] >= 0))
+      cl[idxi] = cl[nhigher[idxi]];
   }
 
   // Find border densities per cluster
+  //   Border points have a neighbour from another cluster at a distance <= dc
+  parallel_for(n, nthreads, 64, border_task, &d);
   bord_rho = (double*) malloc((nclust + 1) * sizeof(double));
-  for (i = 1; i <= nclust; i++) {
+  for (i = 0; i <= nclust; i++)
     bord_rho[i] = 0;
-    for (j = 0; j < n; j++) {
-      if (cl[j] == i) {
-        int k;
-        for (k = 0; k < n; k++) {
-          if ((cl[k] != cl[j]) && (dist[j][k] <= dc) && (rho[j] > bord_rho[i]))
-            bord_rho[i] = rho[j];
-        }
-      }
-    }
+  for (i = 0; i < n; i++) {
+    if ((cl[i] > 0) && border[i] && (rho[i] > bord_rho[cl[i]]))
+      bord_rho[cl[i]] = rho[i];
   }
 
   // Generate Halo
@@ -257,8 +477,11 @@ int dclust(double** dist, int n, profile_struct_annotation* profiles, double cut
   }
 
   // Free structures and exit
+  nn_destroy(d.nn);
   free(cl);
   free(halo);
+  free(nhigher);
+  free(border);
   free(rho);
   free(sortrho);
   free(delta);
@@ -269,59 +492,115 @@ int dclust(double** dist, int n, profile_struct_annotation* profiles, double cut
   return nclust;
 }
 
+/*
+ * dclust
+ *
+ * @see include/annotate/dclust.h
+ */
+int dclust(double** dist, int n, profile_struct_annotation* profiles, double cutoff, int gaussian, double tolerance, double truncation, int nthreads)
+{
+  return(dpclust(dist, NULL, n, profiles, cutoff, gaussian, tolerance, truncation, nthreads));
+}
+
+/*
+ * dclust_graph
+ *
+ * @see include/annotate/dclust.h
+ */
+int dclust_graph(graph_struct* graph, profile_struct_annotation* profiles, double cutoff, int gaussian, double tolerance, double truncation, int nthreads)
+{
+  return(dpclust(NULL, graph, graph->n, profiles, cutoff, gaussian, tolerance, truncation, nthreads));
+}
+
 
-int dclustr_f(double** dist, int n, double dc, int gaussian, profile_struct_annotation** profiles, int ncluster)
+/*
+ * dclustr_f
+ *   Finds the point with the highest density among a set of points and assigns a
+ *   cluster to all the points in the set at a distance <= dc from it
+ *
+ * @arg double** dist
+ *   Distance/dissimilarity matrix. NULL if graph is provided.
+ * @arg graph_struct* graph
+ *   Sparse distance graph. NULL if dist is provided.
+ * @arg int* index
+ *   Indexes of the points in the set, in ascending order
+ * @arg int* position
+ *   Position in index of every point, -1 if it is not in the set
+ * @arg int n
+ *   Number of points in the set
+ * @arg double dc
+ *   Distance cutoff
+ * @arg int gaussian
+ *   0 if no gaussian kernel for density calculation. 1 otherwise.
+ * @arg double truncation
+ *   Gaussian density contributions of points at a distance >= truncation * dc are ignored
+ * @arg profile_struct_annotation* profiles
+ *   An array of profiles
+ * @arg int ncluster
+ *   Cluster number to assign
+ * @arg int* clustered
+ *   Array where the indexes of the clustered points will be stored
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   Number of clustered points
+ */
+int dclustr_f(double** dist, graph_struct* graph, int* index, int* position, int n, double dc, int gaussian, double truncation, profile_struct_annotation* profiles, int ncluster, int* clustered, int nthreads)
 {
   double *rho;
-  int i, j, nclust, grhoidx;
+  int i, nclust, grhoidx;
   double maxrho;
 
   // Initialize structures
   rho = (double*) malloc(sizeof(double) * n);
-  for (i = 0; i < n; i++) rho[i] = 0.0;
-
-  // Calculate RHO[i] per point using gaussian kernel
-  //   RHO[i] = sum {exp(-(dist(i,j)/dc)^2)}
-  if (gaussian) {
-    for(i = 0; i < n; i++) {
-      for(j = i + 1; j < n; j++) {
-        double sq = -(dist[i][j] / (double)dc) * (dist[i][j] / (double)dc);
-        double expsq = exp(sq);
-        rho[i] += expsq;
-        rho[j] += expsq;
-      }
-    }
-  }
 
   // Calculate RHO per point
-  //   RHO[i] = number of points j that satisfy dist(i,j) < dc 
-  if (!gaussian) {
-    for(i = 0; i < n; i++) {
-      for(j = i + 1; j < n; j++) {
-        if(dist[i][j] < dc) {
-          rho[i]++;
-          rho[j]++;
-        }
-      }
-    }
-  }
+  if (graph == NULL)
+    kernel_density(dist, index, n, dc, gaussian, truncation, rho, nthreads);
+  else
+    kernel_density_graph(graph, index, position, n, dc, gaussian, truncation, rho, nthreads);
 
   // Find point with greater RHO and assign cluster
   maxrho = -1;
   grhoidx = -1;
   for (i = 0; i < n; i++) {
     if (maxrho < rho[i]) {
-      grhoidx = i;
+      grhoidx = index[i];
       maxrho = rho[i];
     }
   }
 
   // Assign same cluster to profiles that are at a distance <= dc
   nclust = 0;
-  for (i = 0; i < n; i++) {
-    if (dist[grhoidx][i] <= dc) {
-      nclust++;
-      profiles[i]->cluster = ncluster;
+  if (graph == NULL) {
+    for (i = 0; i < n; i++) {
+      if (dist[grhoidx][index[i]] <= dc) {
+        clustered[nclust++] = index[i];
+        profiles[index[i]].cluster = ncluster;
+      }
+    }
+  }
+  else {
+    long k;
+    clustered[nclust++] = grhoidx;
+    profiles[grhoidx].cluster = ncluster;
+    for (k = graph->offset[grhoidx]; k < graph->offset[grhoidx + 1]; k++) {
+      int j = graph->index[k];
+      if ((position[j] >= 0) && (graph->distance[k] <= dc)) {
+        clustered[nclust++] = j;
+        profiles[j].cluster = ncluster;
+      }
+    }
+
+    // Pairs that are not stored are at the sentinel distance
+    if (graph->sentinel <= dc) {
+      for (i = 0; i < n; i++) {
+        if (profiles[index[i]].cluster < 0) {
+          clustered[nclust++] = index[i];
+          profiles[index[i]].cluster = ncluster;
+        }
+      }
     }
   }
 
@@ -331,77 +610,79 @@ int dclustr_f(double** dist, int n, double dc, int gaussian, profile_struct_anno
 
 
 /*
- * dclustr
+ * dpclustr
+ *   Iterative variation of the clustering by fast search and find of density peaks
+ *   on either a distance matrix or a sparse distance graph
  *
  * @see include/annotate/dclust.h
  */
-int dclustr(double** dist, int n, profile_struct_annotation* profiles, double cf, int gaussian)
+int dpclustr(double** dist, graph_struct* graph, int n, profile_struct_annotation* profiles, double cf, int gaussian, double tolerance, double truncation, int nthreads)
 {
-  double dc, maxd;//, cutoff;
-  int i, j;//, counter;
-  int ncluster, nvisited, stop;
-  //double* allds;
-
-  /*
-  // Calculate distance cutoff
-  if (cutoff < 0)
-    dc = dcoptimize(dist, n, &maxd);
+  double dc, lower, upper;
+  int i, j;
+  int ncluster, nactive, stop;
+  int *index, *position, *clustered;
+  distribution_struct* distribution;
+
+  // Initialize structures
+  //   index : indexes of the points not clustered yet, in ascending order
+  //   position : position of every point in index, -1 if already clustered
+  //   distribution : sorted distances between points not clustered yet
+  index = (int*) malloc(n * sizeof(int));
+  position = (int*) malloc(n * sizeof(int));
+  clustered = (int*) malloc(n * sizeof(int));
+  if (graph == NULL)
+    distribution = distribution_create(dist, n);
   else
-    dc = cutoff;
-  */
-
-  /*
-  allds = (double*) malloc((n * (n - 1) / 2) * sizeof(double));
-  counter = 0;
-  for (i = 0; i < (n - 1); i++) {
-    for(j = i + 1; j < n; j++) {
-      allds[counter] = dist[i][j];
-      counter++;
+    distribution = distribution_create_graph(graph);
+  nactive = 0;
+  for (i = 0; i < n; i++) {
+    position[i] = -1;
+    if (profiles[i].cluster < 0) {
+      position[i] = nactive;
+      index[nactive++] = i;
     }
+    else
+      distribution_remove(distribution, i);
   }
-  qsort(allds, n * (n - 1) / 2, sizeof(double), cmpd);
-  cutoff = gsl_stats_quantile_from_sorted_data(allds, 1, (n * (n - 1)) / 2, 0.02);
-  free(allds);
-  */
 
   // Perform dclustr_f till an empty cluster is found
-  nvisited = 0;
   stop = 0;
   ncluster = 1;
   while (!stop) {
-    // Prepare
-    profile_struct_annotation** prf = (profile_struct_annotation**) malloc((n - nvisited) * sizeof(profile_struct_annotation*));
-    double** dm = (double**) malloc ((n - nvisited) * sizeof(double*));
-    for (i = 0; i < (n - nvisited); i++) dm[i] = (double*) malloc((n - nvisited) * sizeof(double));
-    int idxi = 0;
-    for (i = 0; i < n; i++) {
-      if (profiles[i].cluster < 0) {
-        prf[idxi] = &profiles[i];
-        int idxj = 0;
-        for (j = 0; j < n; j++) {
-          if (profiles[j].cluster < 0) {
-            dm[idxi][idxj] = dist[i][j];
-            idxj++;
-          }
-        }
-        idxi++;
-      }
+    int nv = 0;
+
+    // Calculate distance cutoff for the points not clustered yet
+    //   lower : minimum distance > 0
+    //   upper : distance at 10 percentile
+    if (nactive > 1) {
+      lower = distribution_min_nonzero(distribution);
+      upper = distribution_quantile(distribution, 0.10);
+      dc = (3/sqrt(2)) * dcentropy(dist, graph, index, position, nactive, lower, upper, tolerance, nthreads);
     }
+    else
+      dc = DBL_MAX;
 
     // Cluster
-    dc = dcoptimize(dm, (n - nvisited), &maxd);
-    int nv = 0;
-    if (dc <= cf)//cutoff)
-      nv = dclustr_f(dm, (n - nvisited), dc, gaussian, prf, ncluster);
-    else//if (nv == 1) //else
+    if (dc <= cf)
+      nv = dclustr_f(dist, graph, index, position, nactive, dc, gaussian, truncation, profiles, ncluster, clustered, nthreads);
+    else
       stop++;
 
-    // Finish
-    for (i = 0; i < (n - nvisited); i++) free(dm[i]);
-    nvisited += nv;
+    // Remove clustered points from the active set
+    for (i = 0; i < nv; i++) {
+      distribution_remove(distribution, clustered[i]);
+      position[clustered[i]] = -1;
+    }
+    j = 0;
+    for (i = 0; i < nactive; i++) {
+      if (profiles[index[i]].cluster < 0) {
+        position[index[i]] = j;
+        index[j++] = index[i];
+      }
+    }
+    nactive = j;
     ncluster++;
-    free(dm);
-    free(prf);
   }
 
   // Assign remaining profiles to clusters
@@ -410,5 +691,29 @@ int dclustr(double** dist, int n, profile_struct_annotation* profiles, double cf
   }
 
   // Free and return
+  distribution_destroy(distribution);
+  free(index);
+  free(position);
+  free(clustered);
   return (ncluster - 1);
 }
+
+/*
+ * dclustr
+ *
+ * @see include/annotate/dclust.h
+ */
+int dclustr(double** dist, int n, profile_struct_annotation* profiles, double cf, int gaussian, double tolerance, double truncation, int nthreads)
+{
+  return(dpclustr(dist, NULL, n, profiles, cf, gaussian, tolerance, truncation, nthreads));
+}
+
+/*
+ * dclustr_graph
+ *
+ * @see include/annotate/dclust.h
+ */
+int dclustr_graph(graph_struct* graph, profile_struct_annotation* profiles, double cf, int gaussian, double tolerance, double truncation, int nthreads)
+{
+  return(dpclustr(NULL, graph, graph->n, profiles, cf, gaussian, tolerance, truncation, nthreads));
+}
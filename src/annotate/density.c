@@ -0,0 +1,269 @@
+#include <annotate/density.h>
+
+/*
+ * Struct shared by the density tasks
+ */
+typedef struct {
+  double** dist;
+  graph_struct* graph;
+  int* index;
+  int* position;
+  int n;
+  double dc;
+  int gaussian;
+  double truncation;
+  double width;
+  int nbins;
+  int* histogram;
+  double* weights;
+  double* rho;
+} density_struct;
+
+/*
+ * density_task
+ *   Calculates RHO for point i
+ */
+void density_task(int i, int thread, void* data)
+{
+  density_struct* d = (density_struct*) data;
+  double* row = (d->index == NULL) ? d->dist[i] : d->dist[d->index[i]];
+  double block[DENSITY_BLOCK];
+  double limit, rho;
+  int j, k, count;
+
+  limit = (d->truncation > 0) ? d->truncation * d->dc : DBL_MAX;
+  rho = 0.0;
+  j = 0;
+  while (j < d->n) {
+
+    // Gather a block of distances, skipping point i
+    count = 0;
+    for (; (j < d->n) && (count < DENSITY_BLOCK); j++)
+      if (j != i) block[count++] = (d->index == NULL) ? row[j] : row[d->index[j]];
+
+    // Evaluate the kernel over the block
+    if (d->gaussian) {
+      for (k = 0; k < count; k++) {
+        double x = block[k] / d->dc;
+        block[k] = (block[k] < limit) ? exp(-x * x) : 0.0;
+      }
+      for (k = 0; k < count; k++)
+        rho += block[k];
+    }
+    else {
+      for (k = 0; k < count; k++)
+        rho += (block[k] < d->dc);
+    }
+  }
+
+  d->rho[i] = rho;
+}
+
+/*
+ * kernel_density
+ *
+ * @see include/annotate/density.h
+ */
+void kernel_density(double** dist, int* index, int n, double dc, int gaussian, double truncation, double* rho, int nthreads)
+{
+  density_struct d;
+
+  d.dist = dist;
+  d.index = index;
+  d.n = n;
+  d.dc = dc;
+  d.gaussian = gaussian;
+  d.truncation = truncation;
+  d.rho = rho;
+  parallel_for(n, nthreads, 64, density_task, &d);
+}
+
+/*
+ * graph_density_task
+ *   Calculates RHO for point i from its stored neighbours in a sparse graph.
+ *   Active points that are not stored as neighbours are at the sentinel distance.
+ */
+void graph_density_task(int i, int thread, void* data)
+{
+  density_struct* d = (density_struct*) data;
+  graph_struct* g = d->graph;
+  int node = (d->index == NULL) ? i : d->index[i];
+  double limit, rho, x;
+  long k, missing;
+
+  limit = (d->truncation > 0) ? d->truncation * d->dc : DBL_MAX;
+  rho = 0.0;
+  missing = d->n - 1;
+  for (k = g->offset[node]; k < g->offset[node + 1]; k++) {
+    double dij = g->distance[k];
+    if ((d->position != NULL) && (d->position[g->index[k]] < 0))
+      continue;
+    missing--;
+    if (d->gaussian) {
+      x = dij / d->dc;
+      rho += (dij < limit) ? exp(-x * x) : 0.0;
+    }
+    else
+      rho += (dij < d->dc);
+  }
+
+  // Pairs that are not stored
+  if (d->gaussian) {
+    x = g->sentinel / d->dc;
+    rho += (g->sentinel < limit) ? missing * exp(-x * x) : 0.0;
+  }
+  else
+    rho += (g->sentinel < d->dc) ? missing : 0;
+
+  d->rho[i] = rho;
+}
+
+/*
+ * kernel_density_graph
+ *
+ * @see include/annotate/density.h
+ */
+void kernel_density_graph(graph_struct* graph, int* index, int* position, int n, double dc, int gaussian, double truncation, double* rho, int nthreads)
+{
+  density_struct d;
+
+  d.graph = graph;
+  d.index = index;
+  d.position = position;
+  d.n = n;
+  d.dc = dc;
+  d.gaussian = gaussian;
+  d.truncation = truncation;
+  d.rho = rho;
+  parallel_for(n, nthreads, 64, graph_density_task, &d);
+}
+
+/*
+ * histogram_task
+ *   Bins the distances from point i to the rest of the points of the set
+ */
+void histogram_task(int i, int thread, void* data)
+{
+  density_struct* d = (density_struct*) data;
+  double* row = (d->index == NULL) ? d->dist[i] : d->dist[d->index[i]];
+  int* counts = d->histogram + (long) i * d->nbins;
+  int j, bin;
+
+  for (j = 0; j < d->n; j++) {
+    if (j != i) {
+      double dij = (d->index == NULL) ? row[j] : row[d->index[j]];
+      bin = (int) (dij / d->width);
+      if (bin < d->nbins) counts[bin]++;
+    }
+  }
+}
+
+/*
+ * density_histogram
+ *
+ * @see include/annotate/density.h
+ */
+int* density_histogram(double** dist, int* index, int n, double width, int nbins, int nthreads)
+{
+  density_struct d;
+
+  d.dist = dist;
+  d.index = index;
+  d.n = n;
+  d.width = width;
+  d.nbins = nbins;
+  d.histogram = (int*) calloc((long) n * nbins, sizeof(int));
+  parallel_for(n, nthreads, 64, histogram_task, &d);
+
+  return(d.histogram);
+}
+
+/*
+ * graph_histogram_task
+ *   Bins the distances from point i to the rest of the points of the set in a sparse graph
+ */
+void graph_histogram_task(int i, int thread, void* data)
+{
+  density_struct* d = (density_struct*) data;
+  graph_struct* g = d->graph;
+  int node = (d->index == NULL) ? i : d->index[i];
+  int* counts = d->histogram + (long) i * d->nbins;
+  long k, missing;
+  int bin;
+
+  missing = d->n - 1;
+  for (k = g->offset[node]; k < g->offset[node + 1]; k++) {
+    if ((d->position != NULL) && (d->position[g->index[k]] < 0))
+      continue;
+    missing--;
+    bin = (int) (g->distance[k] / d->width);
+    if (bin < d->nbins) counts[bin]++;
+  }
+
+  // Pairs that are not stored
+  bin = (int) (g->sentinel / d->width);
+  if (bin < d->nbins) counts[bin] += missing;
+}
+
+/*
+ * density_histogram_graph
+ *
+ * @see include/annotate/density.h
+ */
+int* density_histogram_graph(graph_struct* graph, int* index, int* position, int n, double width, int nbins, int nthreads)
+{
+  density_struct d;
+
+  d.graph = graph;
+  d.index = index;
+  d.position = position;
+  d.n = n;
+  d.width = width;
+  d.nbins = nbins;
+  d.histogram = (int*) calloc((long) n * nbins, sizeof(int));
+  parallel_for(n, nthreads, 64, graph_histogram_task, &d);
+
+  return(d.histogram);
+}
+
+/*
+ * binned_task
+ *   Density of point i as the sum of the kernel weights of its binned distances
+ */
+void binned_task(int i, int thread, void* data)
+{
+  density_struct* d = (density_struct*) data;
+  int* counts = d->histogram + (long) i * d->nbins;
+  double rho = 0.0;
+  int b;
+
+  for (b = 0; b < d->nbins; b++)
+    rho += counts[b] * d->weights[b];
+  d->rho[i] = rho;
+}
+
+/*
+ * kernel_density_binned
+ *
+ * @see include/annotate/density.h
+ */
+void kernel_density_binned(int* histogram, int n, double width, int nbins, double dc, double* rho, int nthreads)
+{
+  density_struct d;
+  int b;
+
+  // The kernel is only evaluated once per bin
+  d.weights = (double*) malloc(nbins * sizeof(double));
+  for (b = 0; b < nbins; b++) {
+    double x = ((b + 0.5) * width) / dc;
+    d.weights[b] = exp(-x * x);
+  }
+
+  d.n = n;
+  d.nbins = nbins;
+  d.histogram = histogram;
+  d.rho = rho;
+  parallel_for(n, nthreads, 256, binned_task, &d);
+
+  free(d.weights);
+}
@@ -0,0 +1,355 @@
+#include <annotate/distribution.h>
+
+/*
+ * pair_before
+ *   Order of the pairwise distances: ascending by value, and by pair in case of ties
+ */
+int pair_before(float* value, long x, long y)
+{
+  if (value[x] != value[y]) return(value[x] < value[y]);
+  return(x < y);
+}
+
+/*
+ * pair_sift
+ *   Moves down the element at position i of a max-heap of pairs of size n
+ */
+void pair_sift(float* value, long* order, long i, long n)
+{
+  long child, tmp;
+
+  for (; (child = 2 * i + 1) < n; i = child) {
+    if ((child + 1 < n) && pair_before(value, order[child], order[child + 1]))
+      child++;
+    if (!pair_before(value, order[i], order[child]))
+      return;
+    tmp = order[i]; order[i] = order[child]; order[child] = tmp;
+  }
+}
+
+/*
+ * pair_index
+ *   Position of the pair (i,j) in the condensed upper triangle of a n x n matrix
+ */
+long pair_index(int n, int i, int j)
+{
+  long a = MIN(i, j);
+  long b = MAX(i, j);
+
+  return(a * n - (a * (a + 1)) / 2 + (b - a - 1));
+}
+
+/*
+ * fenwick_add
+ *   Adds a value to position pos (0-based) in a Fenwick tree of size n
+ */
+void fenwick_add(int* tree, long n, long pos, int value)
+{
+  for (pos++; pos <= n; pos += pos & (-pos))
+    tree[pos] += value;
+}
+
+/*
+ * fenwick_prefix
+ *   Sum of positions 0 to pos - 1 in a Fenwick tree
+ */
+long fenwick_prefix(int* tree, long pos)
+{
+  long sum = 0;
+
+  for (; pos > 0; pos -= pos & (-pos))
+    sum += tree[pos];
+
+  return(sum);
+}
+
+/*
+ * fenwick_find
+ *   Position (0-based) of the element with rank k in a Fenwick tree of counts
+ */
+long fenwick_find(int* tree, long n, long step, long k)
+{
+  long pos = 0;
+
+  for (; step > 0; step >>= 1) {
+    if ((pos + step <= n) && (tree[pos + step] <= k)) {
+      pos += step;
+      k -= tree[pos];
+    }
+  }
+
+  return(pos);
+}
+
+/*
+ * distribution_sort
+ *   Sorts the pairwise distances stored by pair in value, without extra memory:
+ *     - rank is sorted as the list of pairs in ascending order of distance by heapsort
+ *     - value is permuted into that order and rank is inverted in place, following the
+ *       cycles of the permutation and using the Fenwick tree as marks
+ *   Then builds the Fenwick tree of active pairs in linear time
+ */
+void distribution_sort(distribution_struct* d)
+{
+  long k, s, npairs = d->size;
+  long* order = d->rank;
+  float* value = d->value;
+  int* mark = d->tree + 1;
+
+  for (k = 0; k < npairs; k++)
+    order[k] = k;
+  for (k = npairs / 2 - 1; k >= 0; k--)
+    pair_sift(value, order, k, npairs);
+  for (k = npairs - 1; k > 0; k--) {
+    long tmp = order[0]; order[0] = order[k]; order[k] = tmp;
+    pair_sift(value, order, 0, k);
+  }
+
+  // value[k] = value[order[k]]
+  for (s = 0; s < npairs; s++) {
+    float first = value[s];
+    if (mark[s]) continue;
+    for (k = s; order[k] != s; k = order[k]) {
+      mark[k] = 1;
+      value[k] = value[order[k]];
+    }
+    mark[k] = 1;
+    value[k] = first;
+  }
+
+  // rank[order[k]] = k
+  for (s = 0; s < npairs; s++) {
+    long current = s, next = order[s];
+    if (!mark[s]) continue;
+    while (mark[next]) {
+      long following = order[next];
+      mark[next] = 0;
+      order[next] = current;
+      current = next;
+      next = following;
+    }
+  }
+
+  d->nzeros = 0;
+  for (k = 0; k < npairs; k++) {
+    if (value[k] == 0) d->nzeros++;
+    d->tree[k + 1] += 1;
+    if (k + 1 + ((k + 1) & (-(k + 1))) <= npairs)
+      d->tree[k + 1 + ((k + 1) & (-(k + 1)))] += d->tree[k + 1];
+  }
+  for (d->step = 1; (d->step << 1) <= npairs; d->step <<= 1);
+}
+
+/*
+ * distribution_create
+ *
+ * @see include/annotate/distribution.h
+ */
+distribution_struct* distribution_create(double** dist, int n)
+{
+  distribution_struct* d;
+  long npairs, p;
+  int i, j;
+
+  // Initialize structures
+  npairs = ((long) n * (n - 1)) / 2;
+  d = (distribution_struct*) malloc(sizeof(distribution_struct));
+  if (d == NULL)
+    return(NULL);
+  d->n = n;
+  d->nactive = n;
+  d->size = npairs;
+  d->npairs = npairs;
+  d->sentinel = 0.0;
+  d->pair = NULL;
+  d->graph = NULL;
+  d->value = (float*) malloc(MAX(npairs, 1) * sizeof(float));
+  d->rank = (long*) malloc(MAX(npairs, 1) * sizeof(long));
+  d->tree = (int*) calloc(npairs + 1, sizeof(int));
+  d->active = (int*) malloc(MAX(n, 1) * sizeof(int));
+  if (d->value == NULL || d->rank == NULL || d->tree == NULL || d->active == NULL) {
+    distribution_destroy(d);
+    return(NULL);
+  }
+
+  // Sort pairwise distances
+  p = 0;
+  for (i = 0; i < n; i++) {
+    d->active[i] = 1;
+    for (j = i + 1; j < n; j++) {
+      d->value[p++] = dist[i][j];
+    }
+  }
+  distribution_sort(d);
+
+  return(d);
+}
+
+/*
+ * distribution_create_graph
+ *
+ * @see include/annotate/distribution.h
+ */
+distribution_struct* distribution_create_graph(graph_struct* g)
+{
+  distribution_struct* d;
+  long npairs, k, p, *reverse;
+  int i;
+
+  // Initialize structures
+  npairs = g->offset[g->n] / 2;
+  d = (distribution_struct*) malloc(sizeof(distribution_struct));
+  reverse = (long*) malloc(MAX(g->n, 1) * sizeof(long));
+  if (d == NULL || reverse == NULL) {
+    free(d);
+    free(reverse);
+    return(NULL);
+  }
+  d->n = g->n;
+  d->nactive = g->n;
+  d->size = npairs;
+  d->npairs = npairs;
+  d->sentinel = g->sentinel;
+  d->graph = g;
+  d->value = (float*) malloc(MAX(npairs, 1) * sizeof(float));
+  d->rank = (long*) malloc(MAX(npairs, 1) * sizeof(long));
+  d->tree = (int*) calloc(npairs + 1, sizeof(int));
+  d->active = (int*) malloc(MAX(g->n, 1) * sizeof(int));
+  d->pair = (long*) malloc(MAX(2 * npairs, 1) * sizeof(long));
+  if (d->value == NULL || d->rank == NULL || d->tree == NULL || d->active == NULL || d->pair == NULL) {
+    free(reverse);
+    distribution_destroy(d);
+    return(NULL);
+  }
+
+  // Number the stored pairs (i,j) with i < j and map both entries of the graph to them
+  //   Rows are sorted by index, so the entries j < i of row i are met in the same
+  //   order as rows j are processed
+  for (i = 0; i < g->n; i++)
+    reverse[i] = g->offset[i];
+  p = 0;
+  for (i = 0; i < g->n; i++) {
+    d->active[i] = 1;
+    for (k = g->offset[i]; k < g->offset[i + 1]; k++) {
+      int j = g->index[k];
+      if (j > i) {
+        d->value[p] = g->distance[k];
+        d->pair[k] = p;
+        d->pair[reverse[j]++] = p;
+        p++;
+      }
+    }
+  }
+  distribution_sort(d);
+
+  free(reverse);
+  return(d);
+}
+
+/*
+ * distribution_remove
+ *
+ * @see include/annotate/distribution.h
+ */
+void distribution_remove(distribution_struct* d, int point)
+{
+  int j;
+
+  if (!d->active[point])
+    return;
+
+  d->active[point] = 0;
+  d->nactive--;
+  if (d->graph == NULL) {
+    for (j = 0; j < d->n; j++) {
+      if (d->active[j]) {
+        fenwick_add(d->tree, d->size, d->rank[pair_index(d->n, point, j)], -1);
+        d->npairs--;
+      }
+    }
+  }
+  else {
+    long k;
+    for (k = d->graph->offset[point]; k < d->graph->offset[point + 1]; k++) {
+      if (d->active[d->graph->index[k]]) {
+        fenwick_add(d->tree, d->size, d->rank[d->pair[k]], -1);
+        d->npairs--;
+      }
+    }
+  }
+}
+
+/*
+ * distribution_get
+ *
+ * @see include/annotate/distribution.h
+ */
+double distribution_get(distribution_struct* d, long k)
+{
+  if (k >= d->npairs)
+    return(d->sentinel);
+  return(d->value[fenwick_find(d->tree, d->size, d->step, k)]);
+}
+
+/*
+ * distribution_quantile
+ *
+ * @see include/annotate/distribution.h
+ */
+double distribution_quantile(distribution_struct* d, double f)
+{
+  long total = ((long) d->nactive * (d->nactive - 1)) / 2;
+  double index = f * (total - 1);
+  long lhs = (long) index;
+  double delta = index - lhs;
+
+  if (total == 0)
+    return(0.0);
+  if (lhs == total - 1)
+    return(distribution_get(d, lhs));
+  return((1 - delta) * distribution_get(d, lhs) + delta * distribution_get(d, lhs + 1));
+}
+
+/*
+ * distribution_min_nonzero
+ *
+ * @see include/annotate/distribution.h
+ */
+double distribution_min_nonzero(distribution_struct* d)
+{
+  long total = ((long) d->nactive * (d->nactive - 1)) / 2;
+  long zeros = fenwick_prefix(d->tree, d->nzeros);
+
+  if ((zeros >= total) || ((zeros >= d->npairs) && (d->sentinel == 0)))
+    return(0.0);
+  return(distribution_get(d, zeros));
+}
+
+/*
+ * distribution_max
+ *
+ * @see include/annotate/distribution.h
+ */
+double distribution_max(distribution_struct* d)
+{
+  long total = ((long) d->nactive * (d->nactive - 1)) / 2;
+
+  if (total == 0)
+    return(0.0);
+  return(distribution_get(d, total - 1));
+}
+
+/*
+ * distribution_destroy
+ *
+ * @see include/annotate/distribution.h
+ */
+void distribution_destroy(distribution_struct* d)
+{
+  free(d->value);
+  free(d->rank);
+  free(d->tree);
+  free(d->active);
+  free(d->pair);
+  free(d);
+}
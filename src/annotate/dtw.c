@@ -68,12 +68,47 @@ double dtw(double* s, int n, double* q, int m) {
 
 
 /*
- * xdtw
+ * xdtw_ceiling
+ *   Maximum normalized correlation that can be reached from a partial alignment with
+ *   cross product c and energies a and b, when the rest of the alignment adds vectors
+ *   of norms at most x and y to both signals. By Cauchy-Schwarz the added cross product
+ *   is at most the product of the added norms, and the maximum over the box [0,x]x[0,y]
+ *   lies on its edges.
+ *
+ * @arg double c, double a, double b
+ *   Cross product and energies of the partial alignment
+ * @arg double x, double y
+ *   Maximum norms of the rest of both signals
+ *
+ * @return
+ *   An upper bound of the final correlation
+ */
+double xdtw_ceiling(double c, double a, double b, double x, double y)
+{
+  double best, t;
+
+  best = c / sqrt(a * b);
+  best = MAX(best, c / sqrt(a * (b + y * y)));
+  best = MAX(best, c / sqrt((a + x * x) * b));
+
+  t = (c > 0) ? MIN(y, x * b / c) : y;
+  best = MAX(best, (c + x * t) / sqrt((a + x * x) * (b + t * t)));
+  t = (c > 0) ? MIN(x, y * a / c) : x;
+  best = MAX(best, (c + t * y) / sqrt((a + t * t) * (b + y * y)));
+
+  return(best);
+}
+
+
+/*
+ * xdtw_bounded
  *
  * @see include/annotate/dtw.h
  */
-double xdtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
+double xdtw_bounded(profile_struct_annotation* p1, profile_struct_annotation* p2, double bound) {
   double warping[MAX_PROFILE_LENGTH][MAX_PROFILE_LENGTH][3];
+  double senergy[MAX_PROFILE_LENGTH + 1], qenergy[MAX_PROFILE_LENGTH + 1];
+  double noise1max, noise2max;
   int i, j, n, m, w;
   double score;
 
@@ -85,6 +120,18 @@ double xdtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
   double* q = p2->profile;
   srand(time(NULL));
 
+  // Energy left in the suffixes of both signals and maximum energy of a gap
+  if (bound > -INFINITY) {
+    senergy[n] = qenergy[m] = 0;
+    for (i = n - 1; i >= 0; i--) senergy[i] = senergy[i + 1] + s[i] * s[i];
+    for (j = m - 1; j >= 0; j--) qenergy[j] = qenergy[j + 1] + q[j] * q[j];
+    noise1max = noise2max = 0;
+    for (i = 0; i < MAX_PROFILE_LENGTH; i++) {
+      noise1max = MAX(noise1max, p1->noise[i] * p1->noise[i]);
+      noise2max = MAX(noise2max, p2->noise[i] * p2->noise[i]);
+    }
+  }
+
   // Initial condition
   warping[0][0][0] = s[0] * q[0];
   warping[0][0][1] = s[0] * s[0];
@@ -147,6 +194,20 @@ double xdtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
         warping[i][j][2] = warping[i][j - 1][2] + q[j] * q[j];
       }
     }
+
+    // Abandon if no cell of the row can lead to a correlation >= bound
+    //   Rows i' > i add s[i'] once each and at most m - 1 - j gaps to the first signal
+    //   Columns j' > j add q[j'] once each and at most n - 1 - i gaps to the second signal
+    if ((bound > -INFINITY) && (i < n - 1)) {
+      double best = -INFINITY;
+      for (j = 0; (j <= stop) && (best < bound); j = (j == 0) ? start : j + 1) {
+        double xleft = sqrt(senergy[i + 1] + (m - 1 - j) * noise1max);
+        double yleft = sqrt(qenergy[j + 1] + (n - 1 - i) * noise2max);
+        best = MAX(best, xdtw_ceiling(warping[i][j][0], warping[i][j][1], warping[i][j][2], xleft, yleft));
+      }
+      if (best < bound)
+        return(XDTW_ABANDONED);
+    }
   }
 
   score = warping[n - 1][m - 1][0] / sqrt(warping[n - 1][m - 1][1] * warping[n - 1][m - 1][2]);
@@ -155,21 +216,33 @@ double xdtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
 }
 
 
+/*
+ * xdtw
+ *
+ * @see include/annotate/dtw.h
+ */
+double xdtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
+  return(xdtw_bounded(p1, p2, -INFINITY));
+}
+
+
 /*
  * adtw
  *
  * @see include/annotate/dtw.h
  */
 double adtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
-  double warping[MAX_PROFILE_LENGTH][MAX_PROFILE_LENGTH][3];
-  double xcorr[MAX_PROFILE_LENGTH][MAX_PROFILE_LENGTH][3];
+  double (*warping)[MAX_PROFILE_LENGTH][3];
+  double (*xcorr)[MAX_PROFILE_LENGTH][3];
   int i, j, n, m, w;
   double score;
 
-  // Initialization
+  // Initialization. Both tables together are larger than the default stack of the calling thread.
   n = p1->length;
   m = p2->length;
   w = abs(n - m);
+  warping = malloc(MAX_PROFILE_LENGTH * sizeof(*warping));
+  xcorr = malloc(MAX_PROFILE_LENGTH * sizeof(*xcorr));
   double* s = (double*) malloc(n * sizeof(double));
   double* q = (double*) malloc(m * sizeof(double));
   srand(time(NULL));
@@ -248,8 +321,8 @@ double adtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
         warping[i][j][1] = i;
         warping[i][j][2] = j - 1;
         xcorr[i][j][0] = noise * q[j] + xcorr[i][j - 1][0];
-        xcorr[i][j][1] = s[i] * s[i] + xcorr[i][j - 1][1];
         xcorr[i][j][1] = noise * noise + xcorr[i][j - 1][1];
+        xcorr[i][j][2] = q[j] * q[j] + xcorr[i][j - 1][2];
       }
     }
   }
@@ -277,6 +350,8 @@ double adtw(profile_struct_annotation* p1, profile_struct_annotation* p2) {
   free(b1);
 
   // Finalization
+  free(warping);
+  free(xcorr);
   free(s);
   free(q);
   return(score);
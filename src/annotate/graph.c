@@ -0,0 +1,128 @@
+#include <annotate/graph.h>
+
+/*
+ * graph_create
+ *
+ * @see include/annotate/graph.h
+ */
+graph_struct* graph_create(int n, double radius, double sentinel)
+{
+  graph_struct* g;
+
+  g = (graph_struct*) malloc(sizeof(graph_struct));
+  if (g == NULL)
+    return(NULL);
+  g->n = n;
+  g->radius = radius;
+  g->sentinel = sentinel;
+  g->nedges = 0;
+  g->capacity = 0;
+  g->first = NULL;
+  g->second = NULL;
+  g->weight = NULL;
+  g->offset = NULL;
+  g->index = NULL;
+  g->distance = NULL;
+
+  return(g);
+}
+
+/*
+ * graph_add
+ *
+ * @see include/annotate/graph.h
+ */
+int graph_add(graph_struct* g, int i, int j, double distance)
+{
+  if (distance > g->radius)
+    return(0);
+
+  // Grow buffers
+  if (g->nedges == g->capacity) {
+    long capacity = MAX(2 * g->capacity, 1024);
+    int* first = (int*) realloc(g->first, capacity * sizeof(int));
+    int* second = (first == NULL) ? NULL : (int*) realloc(g->second, capacity * sizeof(int));
+    double* weight = (second == NULL) ? NULL : (double*) realloc(g->weight, capacity * sizeof(double));
+    if (first != NULL) g->first = first;
+    if (second != NULL) g->second = second;
+    if (weight == NULL)
+      return(-1);
+    g->weight = weight;
+    g->capacity = capacity;
+  }
+
+  g->first[g->nedges] = i;
+  g->second[g->nedges] = j;
+  g->weight[g->nedges] = distance;
+  g->nedges++;
+
+  return(1);
+}
+
+/*
+ * graph_finalize
+ *
+ * @see include/annotate/graph.h
+ */
+int graph_finalize(graph_struct* g)
+{
+  long *next, e;
+  int i;
+
+  g->offset = (long*) calloc(g->n + 1, sizeof(long));
+  g->index = (int*) malloc(MAX(2 * g->nedges, 1) * sizeof(int));
+  g->distance = (double*) malloc(MAX(2 * g->nedges, 1) * sizeof(double));
+  next = (long*) malloc((g->n + 1) * sizeof(long));
+  if (g->offset == NULL || g->index == NULL || g->distance == NULL || next == NULL) {
+    free(next);
+    return(-1);
+  }
+
+  // Count neighbours per point and calculate offsets
+  for (e = 0; e < g->nedges; e++) {
+    g->offset[g->first[e] + 1]++;
+    g->offset[g->second[e] + 1]++;
+  }
+  for (i = 0; i < g->n; i++) {
+    g->offset[i + 1] += g->offset[i];
+    next[i] = g->offset[i];
+  }
+
+  // Pairs come in ascending order of (i, j), so rows are filled in ascending order:
+  // neighbours j < i are added while processing j, before the neighbours j > i
+  for (e = 0; e < g->nedges; e++) {
+    int a = g->first[e];
+    int b = g->second[e];
+    g->index[next[a]] = b;
+    g->distance[next[a]++] = g->weight[e];
+    g->index[next[b]] = a;
+    g->distance[next[b]++] = g->weight[e];
+  }
+
+  // Release buffers
+  free(next);
+  free(g->first);
+  free(g->second);
+  free(g->weight);
+  g->first = g->second = NULL;
+  g->weight = NULL;
+  g->capacity = 0;
+
+  return(0);
+}
+
+/*
+ * graph_destroy
+ *
+ * @see include/annotate/graph.h
+ */
+void graph_destroy(graph_struct* g)
+{
+  free(g->first);
+  free(g->second);
+  free(g->weight);
+  free(g->offset);
+  free(g->index);
+  free(g->distance);
+  free(g);
+}
@@ -2,140 +2,402 @@
 
 /*
  * convert_tree
- *   Recursive function for hc_cluster
+ *   Assigns parents and number of leafs to the nodes of a solution of hc_cluster.
+ *   Children always come before their parents, so nodes are visited in order without recursion.
  *
  * @arg hcnode_struct* tree
  *   A pointer to the hierarchical clustering solution
- * @arg index
- *   Index of the node being visited in the hierarchical clustering solution
+ * @arg int nnodes
+ *   Number of nodes in the hierarchical clustering solution
  */
-void convert_tree(hcnode_struct* tree, int index)
+void convert_tree(hcnode_struct* tree, int nnodes)
 {
-  if (tree[index].left < 0) {
-    int newindex = tree[index].left * (-1) - 1;
-    tree[newindex].parent = (index + 1) * (-1);
-    convert_tree(tree, newindex);
-    tree[index].lleafs += tree[newindex].lleafs;
-    tree[index].lleafs += tree[newindex].rleafs;
-  }
-  else
-    tree[index].lleafs++;
-
-  if (tree[index].right < 0) {
-    int newindex = tree[index].right * (-1) - 1;
-    tree[newindex].parent = (index + 1) * (-1);
-    convert_tree(tree, newindex);
-    tree[index].rleafs += tree[newindex].lleafs;
-    tree[index].rleafs += tree[newindex].rleafs;
+  int index;
+
+  for (index = 0; index < nnodes; index++) {
+    if (tree[index].left < 0) {
+      int newindex = tree[index].left * (-1) - 1;
+      tree[newindex].parent = (index + 1) * (-1);
+      tree[index].lleafs += tree[newindex].lleafs;
+      tree[index].lleafs += tree[newindex].rleafs;
+    }
+    else
+      tree[index].lleafs++;
+
+    if (tree[index].right < 0) {
+      int newindex = tree[index].right * (-1) - 1;
+      tree[newindex].parent = (index + 1) * (-1);
+      tree[index].rleafs += tree[newindex].lleafs;
+      tree[index].rleafs += tree[newindex].rleafs;
+    }
+    else
+      tree[index].rleafs++;
   }
-  else
-    tree[index].rleafs++;
 }
 
 
+/*
+ * Buffered writer for neWick trees
+ */
+typedef struct {
+  FILE* fp;
+  char* data;
+  size_t size;
+} newick_struct;
+
+/*
+ * newick_flush
+ *   Writes the contents of the buffer to the file
+ */
+void newick_flush(newick_struct* nw)
+{
+  fwrite(nw->data, sizeof(char), nw->size, nw->fp);
+  nw->size = 0;
+}
+
+/*
+ * newick_leaf
+ *   Appends a profile to the buffer
+ */
+void newick_leaf(newick_struct* nw, profile_struct_annotation* p)
+{
+  if (nw->size + MAX_FEATURE + 64 > NEWICK_BUFFER)
+    newick_flush(nw);
+  nw->size += sprintf(nw->data + nw->size, "%s_%d-%d_%c", p->chromosome, p->start, p->end, (p->strand == FWD_STRAND) ? '+' : '-');
+}
+
+/*
+ * newick_text
+ *   Appends an opening parenthesis or a distance followed by a separator to the buffer
+ */
+void newick_text(newick_struct* nw, double distance, char separator)
+{
+  if (nw->size + 64 > NEWICK_BUFFER)
+    newick_flush(nw);
+  if (separator == '(')
+    nw->data[nw->size++] = '(';
+  else
+    nw->size += sprintf(nw->data + nw->size, ":%f%c", distance, separator);
+}
+
 /*
  * print_tree
- *   Recursive function for hc_print
+ *   Prints the subtree of a node in neWick format with an explicit stack.
+ *   Stack entries are 3 * node + stage, where stage 0 opens the node and prints its left child,
+ *   stage 1 prints the distance and the right child and stage 2 prints the distance and closes the node.
  *
  * @arg FILE* fp
  *   Pointer to the output file descriptor
  * @arg hcnode_struct* hc
  *   A pointer to the hierarchical clustering solution
  * @arg index
- *   Index of the node being visited in the hierarchical clustering solution
+ *   Index of the node where printing starts
  * @arg profile_struct_annotation* profiles
  *   An array of profiles
  */
 void print_tree(FILE* fp, hcnode_struct* hc, int index, profile_struct_annotation* profiles)
 {
-  fprintf(fp, "(");
+  newick_struct nw;
+  long* stack;
+  long size;
+
+  nw.fp = fp;
+  nw.size = 0;
+  nw.data = (char*) malloc(NEWICK_BUFFER * sizeof(char));
+  stack = (long*) malloc((2 * (long) index + 3) * sizeof(long));
+
+  size = 0;
+  stack[size++] = 3 * (long) index;
+  while (size > 0) {
+    long entry = stack[--size];
+    int node = entry / 3;
+    int stage = entry % 3;
+    int child;
+
+    if (stage == 2) {
+      newick_text(&nw, hc[node].distance, ')');
+      continue;
+    }
 
-  if (hc[index].left < 0) {
-    int new_index = hc[index].left * (-1) - 1;
-    print_tree(fp, hc, new_index, profiles);
-  }
-  else {
-    profile_struct_annotation p = profiles[hc[index].left];
-    if (p.strand == FWD_STRAND) fprintf(fp, "%s_%d-%d_+", p.chromosome, p.start, p.end);
-    else fprintf(fp, "%s_%d-%d_-", p.chromosome, p.start, p.end);
+    if (stage == 0) {
+      newick_text(&nw, 0, '(');
+      child = hc[node].left;
+    }
+    else {
+      newick_text(&nw, hc[node].distance, ',');
+      child = hc[node].right;
+    }
+    stack[size++] = entry + 1;
+    if (child < 0)
+      stack[size++] = 3 * (long) (child * (-1) - 1);
+    else
+      newick_leaf(&nw, &profiles[child]);
   }
+  newick_flush(&nw);
+
+  free(stack);
+  free(nw.data);
+}
+
 
-  fprintf(fp, ":%f,", hc[index].distance);
+/*
+ * Struct for the nearest-neighbour chain algorithm
+ *   dist   : condensed matrix of distances between active clusters. A cluster is represented by one of its profiles.
+ *   active : representatives of the active clusters, in ascending order
+ *   slices : number of slices of active scanned or updated in parallel
+ *   best, bestd : nearest neighbour found in every slice
+ */
+typedef struct {
+  double* dist;
+  int n;
+  int* active;
+  int nactive;
+  int slices;
+  int x;
+  int y;
+  int* best;
+  double* bestd;
+} nnchain_struct;
+
+/*
+ * Position of the distance between i and j in a condensed matrix of n elements
+ */
+long hc_position(int n, int i, int j)
+{
+  if (i > j) { int t = i; i = j; j = t; }
+  return((long) i * (2 * (long) n - i - 1) / 2 + (j - i - 1));
+}
 
-  if (hc[index].right < 0) {
-    int new_index = hc[index].right * (-1) - 1;
-    print_tree(fp, hc, new_index, profiles);
+/*
+ * hc_scan_task
+ *   Nearest active cluster of x within a slice of the active clusters. Ties go to the first one.
+ */
+void hc_scan_task(int index, int thread, void* data)
+{
+  nnchain_struct* nn = (nnchain_struct*) data;
+  int first = (int) ((long) nn->nactive * index / nn->slices);
+  int last = (int) ((long) nn->nactive * (index + 1) / nn->slices);
+  int k, best = -1;
+  double bestd = 0;
+
+  for (k = first; k < last; k++) {
+    int z = nn->active[k];
+    double d;
+    if (z == nn->x)
+      continue;
+    d = nn->dist[hc_position(nn->n, nn->x, z)];
+    if ((best < 0) || (d < bestd)) {
+      best = z;
+      bestd = d;
+    }
   }
-  else {
-    profile_struct_annotation p = profiles[hc[index].right];
-    if (p.strand == FWD_STRAND) fprintf(fp, "%s_%d-%d_+", p.chromosome, p.start, p.end);
-    else fprintf(fp, "%s_%d-%d_-", p.chromosome, p.start, p.end);
+  nn->best[index] = best;
+  nn->bestd[index] = bestd;
+}
+
+/*
+ * hc_update_task
+ *   Complete-linkage update of the distances from y, which is merged with x, to a slice of the active clusters
+ */
+void hc_update_task(int index, int thread, void* data)
+{
+  nnchain_struct* nn = (nnchain_struct*) data;
+  int first = (int) ((long) nn->nactive * index / nn->slices);
+  int last = (int) ((long) nn->nactive * (index + 1) / nn->slices);
+  int k;
+
+  for (k = first; k < last; k++) {
+    int z = nn->active[k];
+    long py, px;
+    if ((z == nn->x) || (z == nn->y))
+      continue;
+    py = hc_position(nn->n, nn->y, z);
+    px = hc_position(nn->n, nn->x, z);
+    if (nn->dist[px] > nn->dist[py])
+      nn->dist[py] = nn->dist[px];
   }
+}
 
-  fprintf(fp, ":%f)", hc[index].distance);
+/*
+ * hc_run
+ *   Runs a scan or update task over the active clusters, in parallel when there are enough of them
+ */
+void hc_run(nnchain_struct* nn, parallel_task task, int threads)
+{
+  nn->slices = (nn->nactive >= HC_PARALLEL_SIZE) ? parallel_threads(nn->nactive, threads) : 1;
+  parallel_for(nn->slices, nn->slices, 1, task, nn);
 }
 
+/*
+ * Merge of two clusters, given by their representatives, found by the nearest-neighbour chain
+ */
+typedef struct {
+  int a;
+  int b;
+  double distance;
+  int order;
+} hcmerge_struct;
 
 /*
- * branch_tree
- *   Recursive function for hc_branch
- *
- * @arg hcnode_struct* hc
- *   A pointer to the hierarchical clustering solution
- * @arg index
- *   Index of the node being visited in the hierarchical clustering solution
- * @arg profile_struct_annotation* profiles
- *   An the array of profiles
- * @arg int cluster
- *   Cluster number
+ * cmpmerge
+ *   Comparison function to sort merges by ascending distance.
+ *   Ties keep the order in which merges were found, so a node always comes after its children.
  */
-void branch_tree(hcnode_struct* hc, int index, profile_struct_annotation* profiles, int cluster)
+int cmpmerge(const void *x, const void *y)
 {
-  // Mark node as visited
-  hc[index].visited = 1;
+  const hcmerge_struct* xx = (const hcmerge_struct*) x;
+  const hcmerge_struct* yy = (const hcmerge_struct*) y;
 
-  // Left leaf
-  if (hc[index].left < 0)
-    branch_tree(hc, hc[index].left * (-1) - 1, profiles, cluster);
-  else
-    profiles[hc[index].left].cluster = cluster;
+  if (xx->distance < yy->distance) return -1;
+  if (xx->distance > yy->distance) return 1;
+  return (xx->order < yy->order) ? -1 : (xx->order > yy->order);
+}
 
-  // Right leaf
-  if (hc[index].right < 0)
-    branch_tree(hc, hc[index].right * (-1) - 1, profiles, cluster);
-  else
-    profiles[hc[index].right].cluster = cluster;
+/*
+ * hc_find
+ *   Root of an element in a union-find forest, with path halving
+ */
+int hc_find(int* parent, int i)
+{
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return(i);
 }
 
+/*
+ * hc_condense_matrix
+ *
+ * @see include/annotate/hierarchical.h
+ */
+double* hc_condense_matrix(double** correlation, int nprofiles)
+{
+  double* dist;
+  int i, j;
+  long k;
+
+  if ((dist = (double*) malloc(MAX((long) nprofiles * (nprofiles - 1) / 2, 1) * sizeof(double))) == NULL)
+    return(NULL);
+
+  for (i = 0, k = 0; i < nprofiles; i++)
+    for (j = i + 1; j < nprofiles; j++)
+      dist[k++] = correlation[i][j];
+
+  return(dist);
+}
 
 /*
  * hc_cluster
  * 
  * @see include/annotate/hierarchical.h
  */
-hcnode_struct* hc_cluster(double** correlation, int nprofiles)
+hcnode_struct* hc_cluster(double* dist, int nprofiles, int threads)
 {
+  nnchain_struct nn;
   hcnode_struct* hc;
-  int i;
+  hcmerge_struct* merges;
+  int *chain, *parent, *label;
+  int i, k, nchain, nmerges;
+
+  hc = (hcnode_struct*) malloc(MAX(nprofiles - 1, 1) * sizeof(hcnode_struct));
+  merges = (hcmerge_struct*) malloc(MAX(nprofiles - 1, 1) * sizeof(hcmerge_struct));
+  chain = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  nn.active = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  nn.best = (int*) malloc(MAX(threads, 1) * sizeof(int));
+  nn.bestd = (double*) malloc(MAX(threads, 1) * sizeof(double));
+  if ((hc == NULL) || (merges == NULL) || (chain == NULL) || (nn.active == NULL) || (nn.best == NULL) || (nn.bestd == NULL)) {
+    free(hc); free(merges); free(chain); free(nn.active); free(nn.best); free(nn.bestd);
+    return(NULL);
+  }
+  nn.dist = dist;
+  nn.n = nprofiles;
+  nn.nactive = nprofiles;
+  for (i = 0; i < nprofiles; i++)
+    nn.active[i] = i;
+
+  // Nearest-neighbour chain: follow nearest neighbours until two clusters are reciprocal nearest neighbours
+  // and merge them. Complete linkage is reducible, so the rest of the chain is still valid after a merge.
+  nchain = 0;
+  nmerges = 0;
+  while (nn.nactive > 1) {
+    int x, y, prev;
+    double d;
+
+    if (nchain == 0)
+      chain[nchain++] = nn.active[0];
+
+    while (1) {
+      x = chain[nchain - 1];
+      prev = (nchain > 1) ? chain[nchain - 2] : -1;
+
+      // Nearest neighbour of x. The previous element of the chain wins ties, so the chain can not cycle.
+      nn.x = x;
+      hc_run(&nn, hc_scan_task, threads);
+      y = -1;
+      d = 0;
+      for (k = 0; k < nn.slices; k++) {
+        if ((nn.best[k] >= 0) && ((y < 0) || (nn.bestd[k] < d))) {
+          y = nn.best[k];
+          d = nn.bestd[k];
+        }
+      }
+      if ((prev >= 0) && (dist[hc_position(nprofiles, x, prev)] <= d)) {
+        y = prev;
+        d = dist[hc_position(nprofiles, x, prev)];
+      }
 
-  // Perform hierarchical clustering
-  Node* tree = treecluster(nprofiles, nprofiles, NULL, NULL, NULL, 0, 'e', 'm', correlation);
+      if (y == prev)
+        break;
+      chain[nchain++] = y;
+    }
 
-  // Deep copy of nodes
-  hc = (hcnode_struct*) malloc((nprofiles - 1) * sizeof(hcnode_struct));
-  for (i = 0; i < (nprofiles - 1); i++) {
-    hc[i].left = tree[i].left;
-    hc[i].right = tree[i].right;
-    hc[i].distance = tree[i].distance;
-    hc[i].parent = nprofiles * (-1);
-    hc[i].lleafs = 0;
-    hc[i].rleafs = 0;
-    hc[i].visited = 0;
+    // Merge x and y. y represents the new cluster and x is no longer active.
+    nchain -= 2;
+    merges[nmerges].a = MIN(x, y);
+    merges[nmerges].b = MAX(x, y);
+    merges[nmerges].distance = d;
+    merges[nmerges].order = nmerges;
+    nmerges++;
+    nn.x = x;
+    nn.y = y;
+    hc_run(&nn, hc_update_task, threads);
+    for (k = 0; nn.active[k] != x; k++);
+    memmove(&nn.active[k], &nn.active[k + 1], (nn.nactive - k - 1) * sizeof(int));
+    nn.nactive--;
   }
-  free(tree);
+
+  // Sort merges by distance and label them as the C Clustering Library does:
+  // node k joins the clusters of a and b, that are either profiles (>= 0) or previous nodes (-(index + 1))
+  qsort(merges, nmerges, sizeof(hcmerge_struct), cmpmerge);
+  parent = chain;
+  label = nn.active;
+  for (i = 0; i < nprofiles; i++) {
+    parent[i] = i;
+    label[i] = i;
+  }
+  for (k = 0; k < nmerges; k++) {
+    int ra = hc_find(parent, merges[k].a);
+    int rb = hc_find(parent, merges[k].b);
+    hc[k].left = label[ra];
+    hc[k].right = label[rb];
+    hc[k].distance = merges[k].distance;
+    hc[k].parent = nprofiles * (-1);
+    hc[k].lleafs = 0;
+    hc[k].rleafs = 0;
+    hc[k].visited = 0;
+    parent[ra] = rb;
+    label[rb] = (k + 1) * (-1);
+  }
+
+  free(merges);
+  free(chain);
+  free(nn.active);
+  free(nn.best);
+  free(nn.bestd);
 
   // Assign parents to nodes
-  convert_tree(hc, nprofiles - 2);
+  convert_tree(hc, nprofiles - 1);
 
   return(hc);
 }
@@ -148,7 +410,8 @@ hcnode_struct* hc_cluster(double** correlation, int nprofiles)
  */
 void hc_print(FILE* fp, hcnode_struct* hc, int nprofiles, profile_struct_annotation* profiles)
 {
-  print_tree(fp, hc, nprofiles - 2, profiles);
+  if (nprofiles > 1)
+    print_tree(fp, hc, nprofiles - 2, profiles);
   fprintf(fp, ";");
 }
 
@@ -161,25 +424,44 @@ void hc_print(FILE* fp, hcnode_struct* hc, int nprofiles, profile_struct_annotat
 int hc_branch(hcnode_struct* hc, int nprofiles, profile_struct_annotation* profiles, double cutoff)
 {
   int i, cluster;
+  int *parent, *leaf, *number;
+
+  parent = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  leaf = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  number = (int*) calloc(MAX(nprofiles, 1), sizeof(int));
+  for (i = 0; i < nprofiles; i++)
+    parent[i] = i;
+
+  // Join the leafs under every node within the cutoff with a union-find over the profiles
+  // Every node is represented by one of its leafs. Nodes come after their children.
+  for (i = 0; i < (nprofiles - 1); i++) {
+    int a = (hc[i].left < 0) ? leaf[hc[i].left * (-1) - 1] : hc[i].left;
+    int b = (hc[i].right < 0) ? leaf[hc[i].right * (-1) - 1] : hc[i].right;
+    leaf[i] = a;
+    hc[i].visited = (hc[i].distance <= cutoff);
+    if (hc[i].visited)
+      parent[hc_find(parent, a)] = hc_find(parent, b);
+  }
 
-  // Assign cluster number to each branch
+  // Assign cluster number to each branch, in the order of the first node of the branch
   cluster = 1;
   for (i = 0; i < (nprofiles - 1); i++) {
-    if (!hc[i].visited) {
-      int root = i;
-      int parent = hc[root].parent * (-1) - 1;
-      while ((root < (nprofiles - 2)) && (hc[root].distance <= cutoff) && (hc[parent].distance <= cutoff)) {
-        root = parent;
-        parent = hc[root].parent * (-1) - 1;
-      }
-      if (hc[root].distance <= cutoff)
-        branch_tree(hc, root, profiles, cluster++);
+    if (hc[i].visited) {
+      int root = hc_find(parent, leaf[i]);
+      if (number[root] == 0)
+        number[root] = cluster++;
     }
   }
+  for (i = 0; i < nprofiles; i++)
+    profiles[i].cluster = number[hc_find(parent, i)];
 
   // Assign cluster number to each individual non-visited leaf
   for (i = 0; i < nprofiles; i++)
-    if (profiles[i].cluster < 0) profiles[i].cluster = cluster++;
+    if (profiles[i].cluster == 0) profiles[i].cluster = cluster++;
+
+  free(parent);
+  free(leaf);
+  free(number);
 
   // Return number of clusters
   return (cluster - 1);
@@ -187,105 +469,274 @@ int hc_branch(hcnode_struct* hc, int nprofiles, profile_struct_annotation* profi
 
 
 /*
- * hc_eval
- *
- * @see include/annotate/hierarchical.h
+ * Struct for the incremental V-measure of a hierarchical solution
+ *   Profiles are joined with a union-find in the order of the merges. Every cluster keeps one list of cells
+ *   of the contingency table between clusters and classes, and lists are merged from the shortest to the longest.
+ *   keys, slots : open addressing hash table from (cluster, class) keys to cells, -1 for empty slots
+ *   sk, skc, sc : sums of n log n over clusters, cells and classes, from which entropies are derived
+ */
+typedef struct {
+  int nclasses;
+  long nannotated;
+  int* parent;
+  int* size;
+  int* head;
+  int* length;
+  int* class;
+  int* count;
+  int* next;
+  long* keys;
+  int* slots;
+  long capacity;
+  long used;
+  double sk;
+  double skc;
+  double sc;
+} vmeasure_struct;
+
+/*
+ * vm_xlogx
+ *   x log x, 0 for x = 0
  */
-double hc_eval(int nprofiles, profile_struct_annotation* profiles)
+double vm_xlogx(double x)
 {
-  int i, j, nclusters, nannotated, nclasses;
-  double score, h_k, h_c, h_conk, h_konc, homogeneity, completeness;
-  int *clusters, *classes;
-  char** names;
-  int** contingency;
-
-  // Initialize variables
-  clusters = (int*) malloc(sizeof(int) * nprofiles);
-  classes = (int*) malloc(sizeof(int) * nprofiles);
-  names = (char**) malloc(sizeof(char*) * nprofiles);
-  contingency = (int**) malloc(sizeof(int*) * nprofiles);
-  for (i = 0; i < nprofiles; i++) {
-    clusters[i] = 0;
-    classes[i] = 0;
-    contingency[i] = (int*) malloc(sizeof(int) * nprofiles);
-    for (j = 0; j < nprofiles; j++) contingency[i][j] = 0;
-  }
+  return((x > 0) ? x * log(x) : 0);
+}
 
-  // Calculate number of classes and number of clusters
-  nclusters = 0;
-  nannotated = 0;
-  nclasses = 0;
-  for (i = 0; i < nprofiles; i++) {
-    profile_struct_annotation p = profiles[i];
-    if (strcmp(p.annotation, "unknown") != 0) {
-      nannotated++;
-      clusters[p.cluster - 1]++;
-      j = 0;
-      while ((j < nclasses) && (strcmp(names[j], p.annotation) != 0)) j++;
-      if (j == nclasses) {
-        names[j] = (char*) malloc(sizeof(char) * MAX_FEATURE);
-        strncpy(names[j], p.annotation, MAX_FEATURE);
-        nclasses++;
+/*
+ * vm_slot
+ *   Slot of a key in the hash table of cells, or the empty slot where it would be inserted
+ */
+long vm_slot(vmeasure_struct* vm, long key)
+{
+  long slot = (key * 0x9E3779B97F4A7C15UL) & (vm->capacity - 1);
+
+  while ((vm->slots[slot] >= 0) && (vm->keys[slot] != key))
+    slot = (slot + 1) & (vm->capacity - 1);
+
+  return(slot);
+}
+
+/*
+ * vm_insert
+ *   Inserts a cell in the hash table, which is doubled when it would be more than half full
+ *
+ * @return
+ *   0 if success. -1 if there is not enough memory.
+ */
+int vm_insert(vmeasure_struct* vm, long key, int cell)
+{
+  long i, slot;
+
+  if (2 * (vm->used + 1) > vm->capacity) {
+    long* keys = vm->keys;
+    int* slots = vm->slots;
+    long capacity = vm->capacity;
+
+    vm->capacity *= 2;
+    vm->keys = (long*) malloc(vm->capacity * sizeof(long));
+    vm->slots = (int*) malloc(vm->capacity * sizeof(int));
+    if ((vm->keys == NULL) || (vm->slots == NULL)) {
+      free(keys);
+      free(slots);
+      return(-1);
+    }
+    for (i = 0; i < vm->capacity; i++)
+      vm->slots[i] = -1;
+    for (i = 0; i < capacity; i++) {
+      if (slots[i] >= 0) {
+        slot = vm_slot(vm, keys[i]);
+        vm->keys[slot] = keys[i];
+        vm->slots[slot] = slots[i];
       }
-      classes[j]++;
-      contingency[p.cluster - 1][j]++;
     }
-    if (nclusters < p.cluster) nclusters = p.cluster;
+    free(keys);
+    free(slots);
   }
 
-  // Calculate H(K)
-  h_k = 0;
-  for (i = 0; i < nclusters; i++) {
-    if (clusters[i] > 0) {
-      double term = ((double) clusters[i]) / ((double) nannotated);
-      double logterm = log2f(term);
-      h_k -= term * logterm;
+  slot = vm_slot(vm, key);
+  vm->keys[slot] = key;
+  vm->slots[slot] = cell;
+  vm->used++;
+
+  return(0);
+}
+
+/*
+ * vm_join
+ *   Joins the clusters of profiles a and b. The cells of the shortest list are added to the longest one.
+ *
+ * @return
+ *   0 if success. -1 if there is not enough memory.
+ */
+int vm_join(vmeasure_struct* vm, int a, int b)
+{
+  int ra = hc_find(vm->parent, a), rb = hc_find(vm->parent, b);
+  int cell, next;
+
+  if (ra == rb)
+    return(0);
+  if (vm->length[ra] < vm->length[rb]) { int t = ra; ra = rb; rb = t; }
+
+  vm->parent[rb] = ra;
+  vm->sk += vm_xlogx(vm->size[ra] + vm->size[rb]) - vm_xlogx(vm->size[ra]) - vm_xlogx(vm->size[rb]);
+  vm->size[ra] += vm->size[rb];
+
+  for (cell = vm->head[rb]; cell >= 0; cell = next) {
+    long key = (long) ra * vm->nclasses + vm->class[cell];
+    long slot = vm_slot(vm, key);
+
+    next = vm->next[cell];
+    if (vm->slots[slot] >= 0) {
+      int other = vm->slots[slot];
+      vm->skc += vm_xlogx(vm->count[other] + vm->count[cell]) - vm_xlogx(vm->count[other]) - vm_xlogx(vm->count[cell]);
+      vm->count[other] += vm->count[cell];
+    }
+    else {
+      if (vm_insert(vm, key, cell) < 0)
+        return(-1);
+      vm->next[cell] = vm->head[ra];
+      vm->head[ra] = cell;
+      vm->length[ra]++;
     }
   }
+  vm->head[rb] = -1;
+  vm->length[rb] = 0;
 
-  // Calculate H(C)
-  h_c = 0;
-  for (i = 0; i < nclasses; i++) {
-    if (classes[i] > 0) {
-      double term = ((double) classes[i]) / ((double) nannotated);
-      double logterm = log2f(term);
-      h_c -= term * logterm;
-    }
+  return(0);
+}
+
+/*
+ * vm_score
+ *   V-measure of the current clusters. Entropies are n log n sums over the annotated profiles:
+ *   H(K) = log N - sk / N, H(C) = log N - sc / N, H(C|K) = (sk - skc) / N and H(K|C) = (sc - skc) / N.
+ *   Entropies within VMEASURE_EPSILON of 0 are taken as 0.
+ */
+double vm_score(vmeasure_struct* vm, double* homogeneity, double* completeness)
+{
+  double n = (double) vm->nannotated;
+  double h_k, h_c, h_conk, h_konc;
+
+  *homogeneity = 1;
+  *completeness = 1;
+  if (vm->nannotated > 0) {
+    h_k = log(n) - vm->sk / n;
+    h_c = log(n) - vm->sc / n;
+    h_conk = (vm->sk - vm->skc) / n;
+    h_konc = (vm->sc - vm->skc) / n;
+    if (h_c > VMEASURE_EPSILON) *homogeneity = 1 - (h_conk / h_c);
+    if (h_k > VMEASURE_EPSILON) *completeness = 1 - (h_konc / h_k);
   }
+  if (*homogeneity + *completeness <= 0)
+    return(0);
+
+  return((2 * *homogeneity * *completeness) / (*homogeneity + *completeness));
+}
 
-  // Calculate H(C|K) and H(K|C)
-  h_conk = 0;
-  h_konc = 0;
-  for (i = 0; i < nclusters; i++) {
-    for (j = 0; j < nclasses; j++) {
-      if (contingency[i][j] > 0) {
-        double term_a = ((double) contingency[i][j]) / ((double) nannotated);
-        double term_b = ((double) contingency[i][j]) / ((double) clusters[i]);
-        double logterm = log2f(term_b);
-        h_conk += term_a * logterm;
-        term_b = ((double) contingency[i][j]) / ((double) classes[j]);
-        logterm = log2f(term_b);
-        h_konc += term_a * logterm;
+/*
+ * hc_cutoff
+ *
+ * @see include/annotate/hierarchical.h
+ */
+double hc_cutoff(hcnode_struct* hc, int nprofiles, profile_struct_annotation* profiles, FILE* fp)
+{
+  double best, score, top;
+  int i, k, nclusters, failed;
+  int *leaf, *classes;
+  chrdict_struct names;
+  vmeasure_struct vm;
+
+  // Intern the classes of the annotated profiles. Every annotated profile starts with one cell.
+  chrdict_init(&names);
+  leaf = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  classes = (int*) calloc(MAX(nprofiles, 1), sizeof(int));
+  vm.parent = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  vm.size = (int*) calloc(MAX(nprofiles, 1), sizeof(int));
+  vm.head = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  vm.length = (int*) calloc(MAX(nprofiles, 1), sizeof(int));
+  vm.class = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  vm.count = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  vm.next = (int*) malloc(MAX(nprofiles, 1) * sizeof(int));
+  vm.capacity = 2;
+  while (vm.capacity < 2 * (long) nprofiles)
+    vm.capacity *= 2;
+  vm.keys = (long*) malloc(vm.capacity * sizeof(long));
+  vm.slots = (int*) malloc(vm.capacity * sizeof(int));
+  failed = (leaf == NULL) || (classes == NULL) || (vm.parent == NULL) || (vm.size == NULL) || (vm.head == NULL) ||
+           (vm.length == NULL) || (vm.class == NULL) || (vm.count == NULL) || (vm.next == NULL) ||
+           (vm.keys == NULL) || (vm.slots == NULL);
+
+  if (!failed) {
+    for (i = 0; i < vm.capacity; i++)
+      vm.slots[i] = -1;
+    vm.used = 0;
+    for (i = 0; i < nprofiles; i++) {
+      vm.parent[i] = i;
+      vm.head[i] = -1;
+      if (strcmp(profiles[i].annotation, "unknown") != 0) {
+        vm.class[i] = chrdict_intern(&names, profiles[i].annotation);
+        vm.count[i] = 1;
+        vm.next[i] = -1;
+        vm.head[i] = i;
+        vm.length[i] = 1;
+        vm.size[i] = 1;
+        classes[vm.class[i]]++;
       }
     }
+    vm.nclasses = names.size;
+    vm.nannotated = 0;
+    vm.sk = 0;
+    vm.skc = 0;
+    vm.sc = 0;
+    for (i = 0; i < names.size; i++) {
+      vm.nannotated += classes[i];
+      vm.sc += vm_xlogx(classes[i]);
+    }
+    for (i = 0; (i < nprofiles) && !failed; i++)
+      if (vm.head[i] >= 0)
+        failed = (vm_insert(&vm, (long) i * vm.nclasses + vm.class[i], i) < 0);
   }
-  h_conk *= -1;
-  h_konc *= -1;
-
-  // Calculate V-measure
-  homogeneity = 1;
-  completeness = 1;
-  if (h_c != 0) homogeneity = 1 - (h_conk / h_c);
-  if (h_k != 0) completeness = 1 - (h_konc / h_k);
-  score = (2 * homogeneity * completeness) / (homogeneity + completeness);
-
-  // Free arrays
-  free(clusters);
-  free(classes);
-  for (i = 0; i < nclasses; i++) free(names[i]);
-  for (i = 0; i < nprofiles; i++) free(contingency[i]);
-  free(names);
-  free(contingency);
 
-  return (score);
+  // Sweep the cutoffs from 0 to the height of the tree, applying the merges of every step in order
+  // Every node is represented by one of its leafs. Nodes come after their children and are sorted by distance.
+  top = (nprofiles > 1) ? hc[nprofiles - 2].distance : 0;
+  best = 0;
+  score = -1;
+  nclusters = nprofiles;
+  k = 0;
+  for (i = 0; (i * HC_CUTOFF_STEP <= top + HC_CUTOFF_STEP) && !failed; i++) {
+    double cutoff = i * HC_CUTOFF_STEP;
+    double v, homogeneity, completeness;
+
+    for (; (k < nprofiles - 1) && (hc[k].distance <= cutoff) && !failed; k++) {
+      int a = (hc[k].left < 0) ? leaf[hc[k].left * (-1) - 1] : hc[k].left;
+      int b = (hc[k].right < 0) ? leaf[hc[k].right * (-1) - 1] : hc[k].right;
+      leaf[k] = a;
+      failed = (vm_join(&vm, a, b) < 0);
+      nclusters--;
+    }
+
+    v = vm_score(&vm, &homogeneity, &completeness);
+    if (fp != NULL)
+      fprintf(fp, "%.2f\t%d\t%f\t%f\t%f\n", cutoff, nclusters, homogeneity, completeness, v);
+    if (v > score) {
+      score = v;
+      best = cutoff;
+    }
+  }
+
+  free(leaf);
+  free(classes);
+  free(vm.parent);
+  free(vm.size);
+  free(vm.head);
+  free(vm.length);
+  free(vm.class);
+  free(vm.count);
+  free(vm.next);
+  free(vm.keys);
+  free(vm.slots);
+  chrdict_destroy(&names);
+
+  return(failed ? -1 : best);
 }
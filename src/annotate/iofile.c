@@ -125,10 +125,6 @@ int next_profile(FILE* fp, profile_struct_annotation* profile)
     return(-1);
   }
 
-  profile->anscore = INT_MIN;
-  profile->cluster = -1;
-  profile->halo = 0;
-
   profile->profile = (double*) malloc((profile->end - profile->start + 1) * sizeof(double));
 
   if ((token = strtok(cline, "\t")) == NULL) {
@@ -147,6 +143,23 @@ int next_profile(FILE* fp, profile_struct_annotation* profile)
     }
   }
 
+  prepare_profile(profile);
+
+  free(cline);
+  free(line);
+  return(1);
+}
+
+/*
+ * prepare_profile
+ *
+ * @see src/include/annotate/iofile.h
+ */
+void prepare_profile(profile_struct_annotation* profile)
+{
+  profile->anscore = INT_MIN;
+  profile->cluster = -1;
+  profile->halo = 0;
   profile->max_height = gsl_stats_max(profile->profile, 1, profile->length);
   profile->mean = gsl_stats_mean(profile->profile, 1, profile->length);
   profile->variance = gsl_stats_variance(profile->profile, 1, profile->length);
@@ -154,64 +167,38 @@ int next_profile(FILE* fp, profile_struct_annotation* profile)
   strncpy(profile->annotation, "unknown", MAX_FEATURE);
   strncpy(profile->tmp_annotation, "unknown", MAX_FEATURE);
   profile->category = NOVEL;
-
-  free(cline);
-  free(line);
-  return(1);
 }
 
 /*
- * next_feature
+ * parse_feature
  *
  * @see include/annotate/iofile.h
  */
-int next_feature(FILE* bedf, feature_struct* feature)
+int parse_feature(char* line, feature_struct* feature)
 {
-  char *line = NULL;
-  char *token, *index;
-  size_t len = 0;
-  ssize_t read;
-
-  read = getline(&line, &len, bedf);
+  char *token, *index, *saveptr;
 
-  if (read < 0) {
-    free(line);
-    return(0);
-  }
-
-  if ((token = strtok(line, "\t")) == NULL) {
-    free(line);
+  if ((token = strtok_r(line, "\t", &saveptr)) == NULL)
     return(-1);
-  }
   strncpy(feature->chromosome, token, MAX_FEATURE);
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
-    free(line);
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL)
     return(-1);
-  }
   feature->start = atoi(token);
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
-    free(line);
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL)
     return(-1);
-  }
   feature->end = atoi(token);
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
-    free(line);
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL)
     return(-1);
-  }
   strncpy(feature->name, token, MAX_FEATURE);
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
-    free(line);
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL)
     return(-1);
-  }
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
-    free(line);
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL)
     return(-1);
-  }
 
   // Check if bed file is BED6 format and remove end of line character
   index = token;
@@ -221,9 +208,32 @@ int next_feature(FILE* bedf, feature_struct* feature)
   if (strcmp(token, "+") == 0) feature->strand = FWD_STRAND;
   else feature->strand = REV_STRAND;
 
+  return(1);
+}
+
+/*
+ * next_feature
+ *
+ * @see include/annotate/iofile.h
+ */
+int next_feature(FILE* bedf, feature_struct* feature)
+{
+  char *line = NULL;
+  size_t len = 0;
+  ssize_t read;
+  int result;
+
+  read = getline(&line, &len, bedf);
+
+  if (read < 0) {
+    free(line);
+    return(0);
+  }
+
+  result = parse_feature(line, feature);
   free(line);
 
-  return(1);
+  return(result);
 }
 
 /*
@@ -259,8 +269,63 @@ int next_correlation(FILE* xcorrf, double* score)
     free(line);
     return(-1);
   }
+  if (token[0] == UNMEASURED_PREFIX) {
+    *score = atof(token + 1);
+    free(line);
+    return(2);
+  }
   *score = atof(token);
 
   free(line);
   return(1);
 }
+
+/*
+ * write_distances_header
+ *
+ * @see include/annotate/iofile.h
+ */
+void write_distances_header(FILE* xcorrf, char* metric, double prune, double sparse)
+{
+  fprintf(xcorrf, "%c%s\t%.17g\t%.17g\n", DISTANCES_HEADER_PREFIX, metric, prune, sparse);
+}
+
+/*
+ * read_distances_header
+ *
+ * @see include/annotate/iofile.h
+ */
+int read_distances_header(FILE* xcorrf, char* metric, double* prune, double* sparse)
+{
+  char *line = NULL;
+  char *token;
+  size_t len = 0;
+  int c;
+
+  c = fgetc(xcorrf);
+  if (c != EOF) ungetc(c, xcorrf);
+  if (c != DISTANCES_HEADER_PREFIX)
+    return(0);
+
+  if ((getline(&line, &len, xcorrf) < 0) || ((token = strtok(line + 1, "\t")) == NULL)) {
+    free(line);
+    return(-1);
+  }
+  strncpy(metric, token, MAX_METRIC - 1);
+  metric[MAX_METRIC - 1] = '\0';
+
+  if ((token = strtok(NULL, "\t")) == NULL) {
+    free(line);
+    return(-1);
+  }
+  *prune = atof(token);
+
+  if ((token = strtok(NULL, "\t\n")) == NULL) {
+    free(line);
+    return(-1);
+  }
+  *sparse = atof(token);
+
+  free(line);
+  return(1);
+}
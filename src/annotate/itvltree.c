@@ -1,42 +1,9 @@
 #include <annotate/itvltree.h>
 
-/*
- * max
- *   A utility function to get maximum of two integers
- */
-int max(int a, int b)
-{
-  return (a > b)? a : b;
-}
-
-/*
- * height
- *   A utility function to get height of the tree
- */
-int height(itnode_struct* root)
-{
-  if (root == NULL)
-    return 0;
-
-  return root->height;
-}
-
 /*
  * do_overlap
- *   A utility function to check if given two intervals overlap
- *   
- *   @args int low_a
- *     Start position of the profile
- *   @args int high_a
- *     End position of the profile
- *   @args int low_b
- *     Start position of the feature
- *   @args int high_b
- *     End position of the feature
- *   @double overlap_a
- *     Percentage of the profile that is covered by the feature
- *   @double overlap_b
- *     Percentage of the feature that is covered by the profile
+ *
+ * @see include/annotate/itvltree.h
  */
 int do_overlap(int low_a, int high_a, int low_b, int high_b, double overlap_a, double overlap_b)
 {
@@ -70,186 +37,169 @@ int do_overlap(int low_a, int high_a, int low_b, int high_b, double overlap_a, d
 }
 
 /*
- * new_itnode
- *   Helper function that allocates a new node with the given key and
- *   NULL left and right pointers
+ * overlap_score
+ *
+ * @see include/annotate/itvltree.h
  */
-itnode_struct* new_itnode(int low, int high, profile_struct_annotation* profile)
+int overlap_score(int low_a, int high_a, int low_b, int high_b)
 {
-  itnode_struct* node = (itnode_struct*) malloc(sizeof(struct itnode_struct));
+  if ((low_a > low_b) && (high_a < high_b))
+    return((high_a - low_a + 1) - (low_a - low_b) - (high_b - high_a));
+  if ((low_a > low_b) && (high_a >= high_b))
+    return((high_b - low_a + 1) - (low_a - low_b));
+  if ((low_a >= low_b) && (high_a < high_b))
+    return((high_a - low_b + 1) - (high_b - high_a));
+  return(high_b - low_b + 1);
+}
 
-  node->low = low;
-  node->high = high;
-  node->profile = profile;
-  node->left   = NULL;
-  node->right  = NULL;
-  node->height = 1;  // new node is initially added at leaf
+/*
+ * cmpitnode
+ *   Comparison function to sort interval tree nodes by low and high
+ */
+int cmpitnode(const void *x, const void *y)
+{
+  const itnode_struct* xx = (const itnode_struct*) x;
+  const itnode_struct* yy = (const itnode_struct*) y;
 
-  return(node);
+  if (xx->low != yy->low) return (xx->low < yy->low) ? -1 : 1;
+  if (xx->high != yy->high) return (xx->high < yy->high) ? -1 : 1;
+  return 0;
 }
 
 /*
- * right_rotate
- *   A utility function to right rotate subtree rooted with y
+ * build_itnodes
+ *   Computes the highest end of the subtree of nodes [a, b) and stores it at its root
  */
-itnode_struct* right_rotate(itnode_struct* y)
+int build_itnodes(itnode_struct* nodes, int a, int b)
 {
-    itnode_struct* x = y->left;
-    itnode_struct* T2 = x->right;
-
-    // Perform rotation
-    x->right = y;
-    y->left = T2;
- 
-    // Update heights
-    y->height = max(height(y->left), height(y->right)) + 1;
-    x->height = max(height(x->left), height(x->right)) + 1;
- 
-    // Return new root
-    return x;
+  int m, max;
+
+  if (a >= b)
+    return(INT_MIN);
+
+  m = a + (b - a) / 2;
+  max = nodes[m].high;
+  max = MAX(max, build_itnodes(nodes, a, m));
+  max = MAX(max, build_itnodes(nodes, m + 1, b));
+  nodes[m].max = max;
+
+  return(max);
 }
 
 /*
- * left_rotate
- *   A utility function to left rotate subtree rooted with x
+ * annotate_itnode
+ *   Overwrites the annotation of the profile of a node if the given interval overlaps it with a higher score
  */
-itnode_struct* left_rotate(itnode_struct* x)
+void annotate_itnode(itnode_struct* node, int low, int high, char* annotation, double overlap_a, double overlap_b)
 {
-  itnode_struct* y = x->right;
-  itnode_struct* T2 = y->left;
- 
-  // Perform rotation
-  y->left = x;
-  x->right = T2;
-
-  //  Update heights
-  x->height = max(height(x->left), height(x->right)) + 1;
-  y->height = max(height(y->left), height(y->right)) + 1;
-
-  // Return new root
-  return y;
+  int score;
+
+  if (!do_overlap(node->low, node->high, low, high, overlap_a, overlap_b))
+    return;
+
+  score = overlap_score(node->low, node->high, low, high);
+  if (score > node->profile->anscore) { 
+    strncpy(node->profile->annotation, annotation, MAX_FEATURE);
+    node->profile->anscore = score;
+    node->profile->category = KNOWN;
+  }
 }
 
 /*
- * get_balance
- *   Get Balance factor of a node
+ * search_itnodes
+ *   Annotates the nodes of the subtree [a, b) that overlap the given interval
  */
-int get_balance(itnode_struct* root)
+void search_itnodes(itnode_struct* nodes, int a, int b, int low, int high, char* annotation, double overlap_a, double overlap_b)
 {
-  if (root == NULL)
-    return 0;
+  while (a < b) {
+    int m = a + (b - a) / 2;
+
+    // No interval of the subtree reaches the given interval
+    if (nodes[m].max < low)
+      return;
+
+    search_itnodes(nodes, a, m, low, high, annotation, overlap_a, overlap_b);
+
+    // Root and right subtree start after the given interval
+    if (nodes[m].low > high)
+      return;
 
-  return height(root->left) - height(root->right);
+    annotate_itnode(&nodes[m], low, high, annotation, overlap_a, overlap_b);
+    a = m + 1;
+  }
 }
 
 /*
- * insert_itnode
+ * itvltree_init
  *
  * @see include/annotate/itvltree.h
  */
-itnode_struct* insert_itnode(itnode_struct* node, int low, int high, profile_struct_annotation* profile)
+void itvltree_init(itvltree_struct* tree)
 {
-  // Perform the normal BST rotation
-  if (node == NULL)
-    return(new_itnode(low, high, profile));
-
-  /* SEEK AND DESTROY */
-  if (high < node->high)
-    node->left  = insert_itnode(node->left, low, high, profile);
-  else
-    node->right = insert_itnode(node->right, low, high, profile);
-
-  // Update height of this ancestor node
-  node->height = max(height(node->left), height(node->right)) + 1;
-
-  // Get the balance factor of this ancestor node to check whether
-  // this node became unbalanced
-  int balance = get_balance(node);
- 
-  // If this node becomes unbalanced, then there are 4 cases
-  // Left Left Case
-  if (balance > 1 && high < node->left->high)
-    return right_rotate(node);
-
-  // Right Right Case
-  if (balance < -1 && high > node->right->high)
-    return left_rotate(node);
-
-  // Left Right Case
-  if (balance > 1 && high > node->left->high) {
-    node->left =  left_rotate(node->left);
-    return right_rotate(node);
-  }
+  tree->nodes = NULL;
+  tree->size = 0;
+  tree->capacity = 0;
+  tree->built = 0;
+}
 
-  // Right Left Case
-  if (balance < -1 && high < node->right->high) {
-    node->right = right_rotate(node->right);
-    return left_rotate(node);
+/*
+ * itvltree_add
+ *
+ * @see include/annotate/itvltree.h
+ */
+int itvltree_add(itvltree_struct* tree, int low, int high, profile_struct_annotation* profile)
+{
+  if (tree->size == tree->capacity) {
+    int capacity = (tree->capacity > 0) ? 2 * tree->capacity : ITVLTREE_CAPACITY;
+    itnode_struct* nodes = (itnode_struct*) realloc(tree->nodes, capacity * sizeof(itnode_struct));
+    if (nodes == NULL)
+      return(-1);
+    tree->nodes = nodes;
+    tree->capacity = capacity;
   }
 
-  // return the (unchanged) node pointer
-  return node;
+  tree->nodes[tree->size].low = low;
+  tree->nodes[tree->size].high = high;
+  tree->nodes[tree->size].max = high;
+  tree->nodes[tree->size].profile = profile;
+  tree->size++;
+  tree->built = 0;
+
+  return(0);
 }
 
 /*
- * search_itnode
- * 
+ * itvltree_build
+ *
  * @see include/annotate/itvltree.h
  */
-void search_itnode(itnode_struct* root, int low, int high, char* annotation, double overlap_a, double overlap_b)
+void itvltree_build(itvltree_struct* tree)
 {
-  // Base Case, tree is empty
-  if (root == NULL)
-    return;
-
-  // If given interval overlaps with root
-  // Check annotation score in order to overwrite annotation
-  if (do_overlap(root->low, root->high, low, high, overlap_a, overlap_b)) {
-    int score;
-
-    if ((root->low > low) && (root->high < high))
-      score = (root->high - root->low + 1) - (root->low - low) - (high - root->high);
-    else if ((root->low > low) && (root->high >= high))
-      score = (high - root->low + 1) - (root->low - low);
-    else if ((root->low >= low) && (root->high < high))
-      score = (root->high - low + 1) - (high - root->high);
-    else
-      score = high - low + 1;
-
-    if (score > root->profile->anscore) { 
-      strncpy(root->profile->annotation, annotation, MAX_FEATURE);
-      root->profile->anscore = score;
-      root->profile->category = KNOWN;
-    }
-  }
+  qsort(tree->nodes, tree->size, sizeof(itnode_struct), cmpitnode);
+  build_itnodes(tree->nodes, 0, tree->size);
+  tree->built = 1;
+}
 
-  // If left child of root is present and max of left child is
-  // greater than or equal to given interval, then i may
-  // overlap with an interval is left subtree
-  if (low < root->low)
-    search_itnode(root->left, low, high, annotation, overlap_a, overlap_b);
+/*
+ * itvltree_search
+ * 
+ * @see include/annotate/itvltree.h
+ */
+void itvltree_search(itvltree_struct* tree, int low, int high, char* annotation, double overlap_a, double overlap_b)
+{
+  if (!tree->built)
+    itvltree_build(tree);
 
-  // Else interval can only overlap with right subtree
-  if (high > root->high)
-    search_itnode(root->right, low, high, annotation, overlap_a, overlap_b);
+  search_itnodes(tree->nodes, 0, tree->size, low, high, annotation, overlap_a, overlap_b);
 }
 
 /*
- * destroy_itnode
+ * itvltree_destroy
  *
  * @see include/annotate/itvltree.h
  */
-void destroy_itnode(itnode_struct* root)
+void itvltree_destroy(itvltree_struct* tree)
 {
-  // Left child
-  if (root->left != NULL) 
-    destroy_itnode(root->left);
-  
-  // Recursive case 2
-  if (root->right != NULL)
-    destroy_itnode(root->right);
-
-  // Base case
-  free(root);
-  root = NULL;
+  free(tree->nodes);
+  itvltree_init(tree);
 }
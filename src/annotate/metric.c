@@ -0,0 +1,263 @@
+#include <annotate/metric.h>
+
+/*
+ * metric_resample
+ *   Resamples a profile into METRIC_LENGTH segments of equal width,
+ *   averaging the heights of the positions covered by each segment
+ */
+void metric_resample(profile_struct_annotation* profile, double* values)
+{
+  double width;
+  int i, k;
+
+  width = (double) profile->length / METRIC_LENGTH;
+  for (k = 0; k < METRIC_LENGTH; k++) {
+    double a = k * width;
+    double b = (k + 1) * width;
+    double sum = 0;
+
+    for (i = (int) a; (i < profile->length) && (i < b); i++)
+      sum += profile->profile[i] * (MIN(b, i + 1) - MAX(a, i));
+    values[k] = sum / width;
+  }
+}
+
+/*
+ * metric_standardize
+ *   Centers values and scales them to unit norm, so that the
+ *   Pearson correlation between two vectors is their dot product
+ */
+void metric_standardize(double* values)
+{
+  double mean = 0, norm = 0;
+  int k;
+
+  for (k = 0; k < METRIC_LENGTH; k++)
+    mean += values[k];
+  mean /= METRIC_LENGTH;
+  for (k = 0; k < METRIC_LENGTH; k++) {
+    values[k] -= mean;
+    norm += values[k] * values[k];
+  }
+  norm = sqrt(norm);
+  for (k = 0; k < METRIC_LENGTH; k++)
+    values[k] = (norm > 0) ? values[k] / norm : 0;
+}
+
+/*
+ * xdtw_kernel, nxcorr_kernel, adtw_kernel
+ *   Alignment-based metrics. They work on the profiles and do not need features.
+ */
+double xdtw_kernel(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  return(xdtw_bounded(p1, p2, bound));
+}
+
+double nxcorr_kernel(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  return(nxcorr(p1, p2));
+}
+
+double adtw_kernel(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  return(adtw(p1, p2));
+}
+
+/*
+ * dtw_kernel
+ *   Sakoe-Chiba DTW between the profiles scaled to unit maximum height. Every step of the warping
+ *   path costs at most two per position it advances, so one minus the cost over twice the length
+ *   of the longest path is a similarity between 0 and 1.
+ */
+double dtw_kernel(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  double s[MAX_PROFILE_LENGTH], q[MAX_PROFILE_LENGTH];
+  double max_s = 0, max_q = 0;
+  int i;
+
+  for (i = 0; i < p1->length; i++) max_s = MAX(max_s, fabs(p1->profile[i]));
+  for (i = 0; i < p2->length; i++) max_q = MAX(max_q, fabs(p2->profile[i]));
+  for (i = 0; i < p1->length; i++) s[i] = (max_s > 0) ? p1->profile[i] / max_s : 0;
+  for (i = 0; i < p2->length; i++) q[i] = (max_q > 0) ? p2->profile[i] / max_q : 0;
+
+  return(1 - dtw(s, p1->length, q, p2->length) / (2 * (p1->length + p2->length - 1)));
+}
+
+/*
+ * pearson_prepare
+ *   Resampled profile, centered and scaled to unit norm
+ */
+void pearson_prepare(profile_struct_annotation* profile, features_struct* features)
+{
+  metric_resample(profile, features->values);
+  metric_standardize(features->values);
+}
+
+/*
+ * spearman_prepare
+ *   Ranks of the resampled profile, with ties sharing their mean rank, centered and scaled to unit norm
+ */
+void spearman_prepare(profile_struct_annotation* profile, features_struct* features)
+{
+  double values[METRIC_LENGTH];
+  int order[METRIC_LENGTH];
+  int i, j, k;
+
+  // Insertion sort of the indexes by value
+  metric_resample(profile, values);
+  for (k = 0; k < METRIC_LENGTH; k++) {
+    for (j = k; (j > 0) && (values[order[j - 1]] > values[k]); j--)
+      order[j] = order[j - 1];
+    order[j] = k;
+  }
+
+  for (i = 0; i < METRIC_LENGTH; i = j) {
+    for (j = i + 1; (j < METRIC_LENGTH) && (values[order[j]] == values[order[i]]); j++);
+    for (k = i; k < j; k++)
+      features->values[order[k]] = (i + j - 1) / 2.0;
+  }
+  metric_standardize(features->values);
+}
+
+/*
+ * kendall_prepare
+ *   Resampled profile
+ */
+void kendall_prepare(profile_struct_annotation* profile, features_struct* features)
+{
+  metric_resample(profile, features->values);
+}
+
+/*
+ * euclid_prepare
+ *   Resampled profile scaled to unit maximum height
+ */
+void euclid_prepare(profile_struct_annotation* profile, features_struct* features)
+{
+  double max = 0;
+  int k;
+
+  metric_resample(profile, features->values);
+  for (k = 0; k < METRIC_LENGTH; k++)
+    max = MAX(max, fabs(features->values[k]));
+  for (k = 0; k < METRIC_LENGTH; k++)
+    features->values[k] = (max > 0) ? features->values[k] / max : 0;
+}
+
+/*
+ * dot_kernel
+ *   Dot product of the features. Pearson and Spearman correlations of standardized features.
+ */
+double dot_kernel(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  double sum = 0;
+  int k;
+
+  for (k = 0; k < METRIC_LENGTH; k++)
+    sum += f1->values[k] * f2->values[k];
+
+  return(sum);
+}
+
+/*
+ * kendall_kernel
+ *   Kendall's tau-b between the features
+ */
+double kendall_kernel(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  double concordant = 0, ties1 = 0, ties2 = 0, pairs = 0;
+  int i, j;
+
+  for (i = 0; i < METRIC_LENGTH; i++) {
+    for (j = i + 1; j < METRIC_LENGTH; j++) {
+      double d1 = f1->values[i] - f1->values[j];
+      double d2 = f2->values[i] - f2->values[j];
+
+      if (d1 == 0) ties1++;
+      if (d2 == 0) ties2++;
+      if ((d1 != 0) && (d2 != 0))
+        concordant += ((d1 > 0) == (d2 > 0)) ? 1 : -1;
+      pairs++;
+    }
+  }
+  if ((ties1 == pairs) || (ties2 == pairs))
+    return(0);
+
+  return(concordant / sqrt((pairs - ties1) * (pairs - ties2)));
+}
+
+/*
+ * euclid_kernel
+ *   One minus the root mean square difference between the features, halved so that it lies between 0 and 1
+ */
+double euclid_kernel(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  double sum = 0;
+  int k;
+
+  for (k = 0; k < METRIC_LENGTH; k++)
+    sum += (f1->values[k] - f2->values[k]) * (f1->values[k] - f2->values[k]);
+
+  return(1 - sqrt(sum / METRIC_LENGTH) / 2);
+}
+
+/*
+ * Registry of metrics
+ */
+metric_struct metrics[] = {
+  {"xdtw", NULL, xdtw_kernel, 1},
+  {"nxcorr", NULL, nxcorr_kernel, 0},
+  {"adtw", NULL, adtw_kernel, 0},
+  {"dtw", NULL, dtw_kernel, 0},
+  {"euclid", euclid_prepare, euclid_kernel, 0},
+  {"pearson", pearson_prepare, dot_kernel, 0},
+  {"spearman", spearman_prepare, dot_kernel, 0},
+  {"kendall", kendall_prepare, kendall_kernel, 0}
+};
+
+/*
+ * metric_find
+ *
+ * @see include/annotate/metric.h
+ */
+int metric_find(char* name)
+{
+  int i;
+
+  for (i = 0; i < (int) (sizeof(metrics) / sizeof(metric_struct)); i++)
+    if (strcmp(metrics[i].name, name) == 0)
+      return(i);
+
+  return(-1);
+}
+
+/*
+ * metric_get
+ *
+ * @see include/annotate/metric.h
+ */
+metric_struct* metric_get(int index)
+{
+  return(&metrics[index]);
+}
+
+/*
+ * metric_prepare
+ *
+ * @see include/annotate/metric.h
+ */
+void metric_prepare(metric_struct* metric, profile_struct_annotation* profile, features_struct* features)
+{
+  if (metric->prepare != NULL)
+    metric->prepare(profile, features);
+}
+
+/*
+ * metric_correlation
+ *
+ * @see include/annotate/metric.h
+ */
+double metric_correlation(metric_struct* metric, profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound)
+{
+  return(metric->correlation(p1, f1, p2, f2, bound));
+}
@@ -0,0 +1,164 @@
+#include <annotate/nnlist.h>
+
+/*
+ * Struct shared by the nn_build tasks
+ */
+typedef struct {
+  double** dist;
+  graph_struct* graph;
+  int n;
+  double radius;
+  nnlist_struct* nn;
+} nnbuild_struct;
+
+/*
+ * cmpnn
+ *   Comparison function to sort neighbours by ascending distance and index
+ */
+int cmpnn(const void *x, const void *y)
+{
+  const neighbour_struct* xx = (const neighbour_struct*) x;
+  const neighbour_struct* yy = (const neighbour_struct*) y;
+
+  if (xx->distance < yy->distance) return -1;
+  if (xx->distance > yy->distance) return 1;
+  if (xx->index < yy->index) return -1;
+  if (xx->index > yy->index) return 1;
+  return 0;
+}
+
+/*
+ * nn_count_task
+ *   Counts the neighbours of point i within the radius
+ */
+void nn_count_task(int i, int thread, void* data)
+{
+  nnbuild_struct* b = (nnbuild_struct*) data;
+  long count = 0;
+  int j;
+
+  if (b->graph == NULL) {
+    double* row = b->dist[i];
+    for (j = 0; j < b->n; j++)
+      if ((j != i) && (row[j] <= b->radius)) count++;
+  }
+  else {
+    long k;
+    for (k = b->graph->offset[i]; k < b->graph->offset[i + 1]; k++)
+      if (b->graph->distance[k] <= b->radius) count++;
+  }
+
+  b->nn->offset[i + 1] = count;
+}
+
+/*
+ * nn_fill_task
+ *   Stores and sorts the neighbours of point i within the radius
+ */
+void nn_fill_task(int i, int thread, void* data)
+{
+  nnbuild_struct* b = (nnbuild_struct*) data;
+  neighbour_struct* neighbours = b->nn->neighbours + b->nn->offset[i];
+  long count = 0;
+  int j;
+
+  if (b->graph == NULL) {
+    double* row = b->dist[i];
+    for (j = 0; j < b->n; j++) {
+      if ((j != i) && (row[j] <= b->radius)) {
+        neighbours[count].distance = row[j];
+        neighbours[count].index = j;
+        count++;
+      }
+    }
+  }
+  else {
+    long k;
+    for (k = b->graph->offset[i]; k < b->graph->offset[i + 1]; k++) {
+      if (b->graph->distance[k] <= b->radius) {
+        neighbours[count].distance = b->graph->distance[k];
+        neighbours[count].index = b->graph->index[k];
+        count++;
+      }
+    }
+  }
+
+  qsort(neighbours, count, sizeof(neighbour_struct), cmpnn);
+}
+
+/*
+ * nn_store
+ *   Builds the neighbour lists from either a distance matrix or a sparse graph
+ */
+nnlist_struct* nn_store(double** dist, graph_struct* graph, int n, double radius, int nthreads)
+{
+  nnlist_struct* nn;
+  nnbuild_struct b;
+  int i;
+
+  // Initialize structures
+  nn = (nnlist_struct*) malloc(sizeof(nnlist_struct));
+  if (nn == NULL)
+    return(NULL);
+  nn->n = n;
+  nn->radius = radius;
+  nn->neighbours = NULL;
+  nn->offset = (long*) malloc((n + 1) * sizeof(long));
+  if (nn->offset == NULL) {
+    free(nn);
+    return(NULL);
+  }
+  b.dist = dist;
+  b.graph = graph;
+  b.n = n;
+  b.radius = radius;
+  b.nn = nn;
+
+  // Count neighbours per point and calculate offsets
+  nn->offset[0] = 0;
+  parallel_for(n, nthreads, 64, nn_count_task, &b);
+  for (i = 0; i < n; i++)
+    nn->offset[i + 1] += nn->offset[i];
+
+  // Store sorted neighbours
+  nn->neighbours = (neighbour_struct*) malloc(MAX(nn->offset[n], 1) * sizeof(neighbour_struct));
+  if (nn->neighbours == NULL) {
+    nn_destroy(nn);
+    return(NULL);
+  }
+  parallel_for(n, nthreads, 64, nn_fill_task, &b);
+
+  return(nn);
+}
+
+/*
+ * nn_build
+ *
+ * @see include/annotate/nnlist.h
+ */
+nnlist_struct* nn_build(double** dist, int n, double radius, int nthreads)
+{
+  return(nn_store(dist, NULL, n, radius, nthreads));
+}
+
+/*
+ * nn_build_graph
+ *
+ * @see include/annotate/nnlist.h
+ */
+nnlist_struct* nn_build_graph(graph_struct* graph, double radius, int nthreads)
+{
+  return(nn_store(NULL, graph, graph->n, radius, nthreads));
+}
+
+/*
+ * nn_destroy
+ *
+ * @see include/annotate/nnlist.h
+ */
+void nn_destroy(nnlist_struct* nn)
+{
+  free(nn->offset);
+  free(nn->neighbours);
+  free(nn);
+}
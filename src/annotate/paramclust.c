@@ -11,7 +11,7 @@ int parse_command_line_c(int argc, char** argv, char** error_message, args_a_str
   char carg;
   int terminate = 0;
 
-  while(((carg = getopt(argc, argv, "hva:o:x:")) != -1) && (terminate >= 0)) {
+  while(((carg = getopt(argc, argv, "hvwa:o:x:j:p:s:d:c:")) != -1) && (terminate >= 0)) {
     switch (carg) {
       case 'h':
         terminate--;
@@ -21,6 +21,9 @@ int parse_command_line_c(int argc, char** argv, char** error_message, args_a_str
         terminate--;
         *error_message = VERSION_MSG;
         break;
+      case 'w':
+        arguments->sweep = 1;
+        break;
       case 'a':
         terminate = parse_annotation_parameters(optarg, error_message, arguments);
         break;
@@ -30,12 +33,30 @@ int parse_command_line_c(int argc, char** argv, char** error_message, args_a_str
       case 'x':
         terminate = parse_xcorr_parameters(optarg, error_message, arguments);
         break;
+      case 'j':
+        terminate = parse_threads_parameters(optarg, error_message, arguments);
+        break;
+      case 'p':
+        terminate = parse_prune_parameters(optarg, error_message, arguments);
+        break;
+      case 's':
+        terminate = parse_sparse_parameters(optarg, error_message, arguments);
+        break;
+      case 'd':
+        terminate = parse_metric_parameters(optarg, error_message, arguments);
+        break;
+      case 'c':
+        terminate = parse_clustering_parameters(optarg, error_message, arguments);
+        break;
       case '?':
         terminate--;
         *error_message = ERR_INVALID_ARGUMENT;
     }
   }
 
+  if (!terminate)
+    terminate = check_annotate_arguments(arguments, error_message);
+
   if (!terminate && (argc - optind) != 2) {
     terminate--;
     *error_message = ERR_INVALID_NUMBER_ARGUMENTS;
@@ -47,6 +68,29 @@ int parse_command_line_c(int argc, char** argv, char** error_message, args_a_str
   return(terminate);
 }
 
+/*
+ * check_annotate_arguments
+ *
+ * @see src/include/annotate/paramclust.h
+ */
+int check_annotate_arguments(args_a_struct* arguments, char** error_message)
+{
+  // The cutoff of hierarchical clustering is selected with the annotation when it is not given
+  if ((arguments->clustering == CLUSTERING_HIERARCHICAL) && (arguments->cluster_cutoff < 0) && !arguments->annotation) {
+    *error_message = ERR_INVALID_c_VALUE;
+    return(-1);
+  }
+  if ((arguments->sparse > 0) && (arguments->clustering == CLUSTERING_HIERARCHICAL)) {
+    *error_message = ERR_SPARSE_HC;
+    return(-1);
+  }
+  if ((arguments->prune < 1) && !metric_get(arguments->metric)->prunable) {
+    *error_message = ERR_PRUNE_METRIC;
+    return(-1);
+  }
+  return(0);
+}
+
 /*
  * parse_annotation_parameters
  *
@@ -127,3 +171,127 @@ int parse_xcorr_parameters(char* option, char** error_message, args_a_struct* ar
 
   return(0);
 }
+
+
+/*
+ * parse_threads_parameters
+ *
+ * @see include/annotate/paramclust.h
+ */
+int parse_threads_parameters(char* option, char** error_message, args_a_struct* arguments)
+{
+  arguments->threads = atoi(option);
+  if (arguments->threads < 1) {
+    *error_message = ERR_INVALID_j_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_prune_parameters
+ *
+ * @see include/annotate/paramclust.h
+ */
+int parse_prune_parameters(char* option, char** error_message, args_a_struct* arguments)
+{
+  arguments->prune = atof(option);
+  if (arguments->prune < 0 || arguments->prune > 1) {
+    *error_message = ERR_INVALID_p_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_sparse_parameters
+ *
+ * @see include/annotate/paramclust.h
+ */
+int parse_sparse_parameters(char* option, char** error_message, args_a_struct* arguments)
+{
+  arguments->sparse = atof(option);
+  if (arguments->sparse <= 0 || arguments->sparse > 1) {
+    *error_message = ERR_INVALID_s_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_metric_parameters
+ *
+ * @see include/annotate/paramclust.h
+ */
+int parse_metric_parameters(char* option, char** error_message, args_a_struct* arguments)
+{
+  arguments->metric = metric_find(option);
+  if (arguments->metric < 0) {
+    *error_message = ERR_INVALID_d_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_clustering_parameters
+ *
+ * @see include/annotate/paramclust.h
+ */
+int parse_clustering_parameters(char* option, char** error_message, args_a_struct* arguments)
+{
+  char* token;
+
+  if ((token = strtok(option, ":")) == NULL) {
+    *error_message = ERR_INVALID_c_VALUE;
+    return(-1);
+  }
+
+  if (strcmp(token, "dpclust") == 0)
+    arguments->clustering = CLUSTERING_DPCLUST;
+  else if (strcmp(token, "hc") == 0)
+    arguments->clustering = CLUSTERING_HIERARCHICAL;
+  else {
+    *error_message = ERR_INVALID_c_VALUE;
+    return(-1);
+  }
+
+  if (((token = strtok(NULL, ":")) != NULL) && (arguments->clustering == CLUSTERING_HIERARCHICAL)) {
+    arguments->cluster_cutoff = atof(token);
+    if (arguments->cluster_cutoff < 0) {
+      *error_message = ERR_INVALID_c_VALUE;
+      return(-1);
+    }
+  }
+  else if (token != NULL) {
+    arguments->dc_tolerance = atof(token);
+    if (arguments->dc_tolerance < DC_MIN_TOLERANCE) {
+      *error_message = ERR_INVALID_c_VALUE;
+      return(-1);
+    }
+  }
+
+  if (((token = strtok(NULL, ":")) != NULL) && (arguments->clustering == CLUSTERING_DPCLUST)) {
+    arguments->kernel_truncation = atof(token);
+    if (arguments->kernel_truncation < 0) {
+      *error_message = ERR_INVALID_c_VALUE;
+      return(-1);
+    }
+    token = strtok(NULL, ":");
+  }
+
+  if (token != NULL) {
+    *error_message = ERR_INVALID_c_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
@@ -7,63 +7,12 @@
  */
 int map_search(map_struct* map, char* chrom, int strand)
 {
-  int imax = map->size;
-  int imin = 0;
-  char* id = (char*) malloc(MAX_FEATURE * sizeof(char));
-
-  // Build identifier
-  strncpy(id, chrom, MAX_FEATURE);
-  if (strand == FWD_STRAND)
-    strcat(id, "+\0");
-  else
-    strcat(id, "-\0");
-
-  imax--;
-  while (imax >= imin) {
-    int imid = imin + ((imax - imin) / 2);
-
-    int result = strcmp(map->elements[imid].identifier, id);
-    if(result == 0) {
-      free(id);
-      return imid;
-    }
-    else if (result < 0)
-      imin = imid + 1;
-    else         
-      imax = imid - 1;
-  }
+  int id;
 
-  free(id);
-  return -1;
-}
+  if ((id = chrdict_find(&map->chromosomes, chrom)) < 0)
+    return -1;
 
-/*
- * insert_sort
- *
- * @see include/annotate/profilemap.h
- */
-void map_sort(map_struct* map)
-{
-  int i;
-  int j;
-
-  for(i = 0; i < map->size; i++) {
-    char* id_x = (char*) malloc(sizeof(char) * MAX_FEATURE);
-    itnode_struct* p_x;
-    strncpy(id_x, map->elements[i].identifier, MAX_FEATURE);
-    p_x = map->elements[i].root;
-
-    j = i;
-    while(j > 0 && strcmp(map->elements[j - 1].identifier, id_x) > 0) {
-      strncpy(map->elements[j].identifier, map->elements[j - 1].identifier, MAX_FEATURE);
-      map->elements[j].root = map->elements[j - 1].root;
-      j--;
-    }
-
-    strncpy(map->elements[j].identifier, id_x, MAX_FEATURE);
-    map->elements[j].root = p_x;
-    free(id_x);
-  }
+  return 2 * id + strand;
 }
 
 /*
@@ -73,6 +22,7 @@ void map_sort(map_struct* map)
  */
 void map_init(map_struct* map)
 {
+  chrdict_init(&map->chromosomes);
   map->elements = NULL;
   map->size = 0;
 }
@@ -84,51 +34,37 @@ void map_init(map_struct* map)
  */
 void map_add_profile(map_struct* map, profile_struct_annotation* profile)
 {
-  char* id = (char*) malloc(MAX_FEATURE * sizeof(char));
-
-  // Build identifier
-  strncpy(id, profile->chromosome, MAX_FEATURE);
-  if (profile->strand == FWD_STRAND)
-    strcat(id, "+\0");
-  else
-    strcat(id, "-\0");
-
-  // Map is empty
-  if (map->size == 0) {
-    map->elements = (map_element_struct*) malloc(sizeof(map_element_struct) * (map->size + 1));
-    strncpy(map->elements[map->size].identifier, id, MAX_FEATURE);
-    map->elements[map->size].root = insert_itnode(NULL, profile->start, profile->end, profile);
-    map->size++;
-  }
+  int id = chrdict_intern(&map->chromosomes, profile->chromosome);
+
+  if (id < 0)
+    return;
 
-  // Map is not empty
-  else {
-    int mapidx = map_search(map, profile->chromosome, profile->strand);
-
-    // Element does not exist
-    if (mapidx < 0) {
-      map_element_struct* tmp_map = (map_element_struct*) realloc(map->elements, sizeof(map_element_struct) * (map->size + 1));
-      if (tmp_map == NULL)
-        free(map->elements);
-      map->elements = tmp_map;
-
-      tmp_map = (map_element_struct*) realloc(map->elements, sizeof(map_element_struct) * (map->size + 1));
-      if (tmp_map == NULL)
-        free(map->elements);
-      map->elements = tmp_map;
-
-      strncpy(map->elements[map->size].identifier, id, MAX_FEATURE);
-      map->elements[map->size].root = insert_itnode(NULL, profile->start, profile->end, profile);
-      map->size++;
-      map_sort(map);
-    }
-
-    // Element does exist
-    else
-      map->elements[mapidx].root = insert_itnode(map->elements[mapidx].root, profile->start, profile->end, profile);
+  // New chromosome. Elements grow with the dictionary, so they are reallocated only when its table grows.
+  if (2 * map->chromosomes.size > map->size) {
+    int i, size = map->chromosomes.capacity;
+    map_element_struct* tmp_map = (map_element_struct*) realloc(map->elements, sizeof(map_element_struct) * size);
+    if (tmp_map == NULL)
+      return;
+    map->elements = tmp_map;
+    for (i = map->size; i < size; i++)
+      itvltree_init(&map->elements[i].tree);
+    map->size = size;
   }
 
-  free(id);
+  itvltree_add(&map->elements[2 * id + profile->strand].tree, profile->start, profile->end, profile);
+}
+
+/*
+ * map_build
+ *
+ * @see include/annotate/profilemap.h
+ */
+void map_build(map_struct* map)
+{
+  int i;
+
+  for (i = 0; i < map->size; i++)
+    itvltree_build(&map->elements[i].tree);
 }
 
 /*
@@ -143,7 +79,30 @@ void map_annotate(args_a_struct* arguments, map_struct* map, char* chrom, int st
   if ((position = map_search(map, chrom, strand)) < 0)
     return;
 
-  search_itnode(map->elements[position].root, start, end, feature, arguments->overlap_ftop, arguments->overlap_ptof);
+  itvltree_search(&map->elements[position].tree, start, end, feature, arguments->overlap_ftop, arguments->overlap_ptof);
+}
+
+/*
+ * map_annotate_batch
+ *
+ * @see include/annotate/profilemap.h
+ */
+void map_annotate_batch(args_a_struct* arguments, map_struct* map, feature_struct* features, long nfeatures)
+{
+  long i;
+  int position = -1;
+
+  for (i = 0; i < nfeatures; i++) {
+    feature_struct* f = &features[i];
+
+    // Features are usually sorted, so the tree of the previous feature is reused while the chromosome and strand do not change
+    if ((i == 0) || (f->strand != features[i - 1].strand) || (strcmp(f->chromosome, features[i - 1].chromosome) != 0))
+      position = map_search(map, f->chromosome, f->strand);
+    if (position < 0)
+      continue;
+
+    itvltree_search(&map->elements[position].tree, f->start, f->end, f->name, arguments->overlap_ftop, arguments->overlap_ptof);
+  }
 }
 
 /*
@@ -155,7 +114,8 @@ void map_destroy(map_struct* map) {
   int i;
 
   for (i = 0; i < map->size; i++)
-    destroy_itnode(map->elements[i].root);
+    itvltree_destroy(&map->elements[i].tree);
 
   free(map->elements);
+  chrdict_destroy(&map->chromosomes);
 }
@@ -0,0 +1,85 @@
+#include <annotate/prune.h>
+
+/*
+ * prune_build
+ *
+ * @see include/annotate/prune.h
+ */
+void prune_build(profile_struct_annotation* profile, prune_struct* prune)
+{
+  int i;
+
+  prune->energy = 0;
+  prune->mass = 0;
+  for (i = 0; i < profile->length; i++) {
+    prune->energy += profile->profile[i] * profile->profile[i];
+    if (i > 0) prune->mass += fabs(profile->profile[i]);
+  }
+
+  prune->noise = 0;
+  for (i = 0; i < MAX_PROFILE_LENGTH; i++)
+    prune->noise = MAX(prune->noise, fabs(profile->noise[i]));
+}
+
+/*
+ * band_products
+ *   Maximum sum of the cross products of the positions i >= 1 of s, when each of them is aligned
+ *   either with a position j >= 1 of q within the band |i - j| <= w or with a gap of magnitude
+ *   at most gap. The maximum and minimum of q over the band are kept in monotonic queues.
+ */
+double band_products(double* s, int n, double* q, int m, int w, double gap)
+{
+  int upper[MAX_PROFILE_LENGTH], lower[MAX_PROFILE_LENGTH];
+  int uhead, utail, lhead, ltail, i, j;
+  double sum;
+
+  uhead = utail = lhead = ltail = 0;
+  sum = 0;
+  j = 1;
+  for (i = 1; i < n; i++) {
+    double best = fabs(s[i]) * gap;
+
+    // Slide the band to [i - w, i + w]
+    for (; j <= MIN(i + w, m - 1); j++) {
+      while ((utail > uhead) && (q[upper[utail - 1]] <= q[j])) utail--;
+      upper[utail++] = j;
+      while ((ltail > lhead) && (q[lower[ltail - 1]] >= q[j])) ltail--;
+      lower[ltail++] = j;
+    }
+    while ((uhead < utail) && (upper[uhead] < i - w)) uhead++;
+    while ((lhead < ltail) && (lower[lhead] < i - w)) lhead++;
+
+    if (uhead < utail)
+      best = MAX(best, MAX(s[i] * q[upper[uhead]], s[i] * q[lower[lhead]]));
+    sum += best;
+  }
+
+  return(sum);
+}
+
+/*
+ * prune_distance
+ *
+ * @see include/annotate/prune.h
+ */
+double prune_distance(profile_struct_annotation* p1, prune_struct* b1, profile_struct_annotation* p2, prune_struct* b2)
+{
+  double c12, c21, ceiling;
+  int w;
+
+  if ((b1->energy <= 0) || (b2->energy <= 0))
+    return(0);
+
+  // Cross product of the first cells, of the positions of one profile against the other
+  // and of the gaps of the other profile against noise. Keep the tightest of both ways.
+  w = abs(p1->length - p2->length);
+  c12 = p1->profile[0] * p2->profile[0] + band_products(p1->profile, p1->length, p2->profile, p2->length, w, b2->noise) + b1->noise * b2->mass;
+  c21 = p1->profile[0] * p2->profile[0] + band_products(p2->profile, p2->length, p1->profile, p1->length, w, b1->noise) + b2->noise * b1->mass;
+
+  // Gaps only add energy to the signals, so the energies of the profiles bound the denominator
+  ceiling = MIN(c12, c21) / sqrt(b1->energy * b2->energy);
+  if (ceiling < 0) ceiling = 0;
+  if (ceiling > 1) ceiling = 1;
+
+  return(1 - ceiling);
+}
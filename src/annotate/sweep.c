@@ -0,0 +1,235 @@
+#include <annotate/sweep.h>
+
+/*
+ * Profile or feature being swept. index is its position in the array of profiles or features.
+ */
+typedef struct {
+  int chromosome;
+  int strand;
+  int start;
+  int end;
+  long index;
+} sweepitem_struct;
+
+/*
+ * Chromosome and strand swept by a task
+ *   profiles : items [pfirst, plast) of the sorted profiles
+ *   features : items [ffirst, flast) of the sorted features
+ */
+typedef struct {
+  long pfirst;
+  long plast;
+  long ffirst;
+  long flast;
+  long cost;
+} sweepgroup_struct;
+
+/*
+ * Struct shared by the sweep tasks
+ */
+typedef struct {
+  args_a_struct* arguments;
+  profile_struct_annotation* profiles;
+  feature_struct* features;
+  sweepitem_struct* pitems;
+  sweepitem_struct* fitems;
+  sweepgroup_struct* groups;
+} sweep_struct;
+
+/*
+ * cmpsweep
+ *   Comparison function to sort sweep items by chromosome identifier, strand, start and index
+ */
+int cmpsweep(const void *x, const void *y)
+{
+  const sweepitem_struct* xx = (const sweepitem_struct*) x;
+  const sweepitem_struct* yy = (const sweepitem_struct*) y;
+
+  if (xx->chromosome != yy->chromosome) return (xx->chromosome < yy->chromosome) ? -1 : 1;
+  if (xx->strand != yy->strand) return (xx->strand < yy->strand) ? -1 : 1;
+  if (xx->start != yy->start) return (xx->start < yy->start) ? -1 : 1;
+  if (xx->index < yy->index) return -1;
+  if (xx->index > yy->index) return 1;
+  return 0;
+}
+
+/*
+ * cmpgroup
+ *   Comparison function to sort groups by descending cost, so the largest ones are scheduled first
+ */
+int cmpgroup(const void *x, const void *y)
+{
+  const sweepgroup_struct* xx = (const sweepgroup_struct*) x;
+  const sweepgroup_struct* yy = (const sweepgroup_struct*) y;
+
+  if (xx->cost > yy->cost) return -1;
+  if (xx->cost < yy->cost) return 1;
+  return 0;
+}
+
+/*
+ * cmplocation
+ *   Compares the chromosome and strand of two sweep items
+ */
+int cmplocation(const sweepitem_struct* x, const sweepitem_struct* y)
+{
+  if (x->chromosome != y->chromosome) return (x->chromosome < y->chromosome) ? -1 : 1;
+  if (x->strand != y->strand) return (x->strand < y->strand) ? -1 : 1;
+  return 0;
+}
+
+/*
+ * sweep_task
+ *   Sweeps the profiles and features of a chromosome and strand.
+ *   Every overlapping pair is found when the one that starts later is reached, since the other one is still active.
+ *   The best feature of every profile is kept in local arrays, ties being broken by the order of the features.
+ */
+void sweep_task(int index, int thread, void* data)
+{
+  sweep_struct* d = (sweep_struct*) data;
+  sweepgroup_struct* g = &d->groups[index];
+  long np = g->plast - g->pfirst;
+  long nf = g->flast - g->ffirst;
+  long *pactive, *factive, *best;
+  double* score;
+  long npactive = 0, nfactive = 0, p, f, k, kept;
+
+  pactive = (long*) malloc(MAX(np, 1) * sizeof(long));
+  factive = (long*) malloc(MAX(nf, 1) * sizeof(long));
+  best = (long*) malloc(MAX(np, 1) * sizeof(long));
+  score = (double*) malloc(MAX(np, 1) * sizeof(double));
+  for (p = 0; p < np; p++) {
+    best[p] = -1;
+    score[p] = d->profiles[d->pitems[g->pfirst + p].index].anscore;
+  }
+
+  p = f = 0;
+  while ((p < np) || (f < nf)) {
+    sweepitem_struct* pi = &d->pitems[g->pfirst + MIN(p, np - 1)];
+    sweepitem_struct* fi = &d->fitems[g->ffirst + MIN(f, nf - 1)];
+
+    // Next item is a profile. Features that end before it starts cannot overlap anymore.
+    if ((f == nf) || ((p < np) && (pi->start <= fi->start))) {
+      for (k = 0, kept = 0; k < nfactive; k++) {
+        sweepitem_struct* a = &d->fitems[g->ffirst + factive[k]];
+        if (a->end < pi->start)
+          continue;
+        factive[kept++] = factive[k];
+        if (do_overlap(pi->start, pi->end, a->start, a->end, d->arguments->overlap_ftop, d->arguments->overlap_ptof)) {
+          int s = overlap_score(pi->start, pi->end, a->start, a->end);
+          if ((s > score[p]) || ((s == score[p]) && (best[p] >= 0) && (a->index < best[p]))) {
+            score[p] = s;
+            best[p] = a->index;
+          }
+        }
+      }
+      nfactive = kept;
+      pactive[npactive++] = p++;
+    }
+
+    // Next item is a feature. Profiles that end before it starts cannot overlap anymore.
+    else {
+      for (k = 0, kept = 0; k < npactive; k++) {
+        long q = pactive[k];
+        sweepitem_struct* a = &d->pitems[g->pfirst + q];
+        if (a->end < fi->start)
+          continue;
+        pactive[kept++] = q;
+        if (do_overlap(a->start, a->end, fi->start, fi->end, d->arguments->overlap_ftop, d->arguments->overlap_ptof)) {
+          int s = overlap_score(a->start, a->end, fi->start, fi->end);
+          if ((s > score[q]) || ((s == score[q]) && (best[q] >= 0) && (fi->index < best[q]))) {
+            score[q] = s;
+            best[q] = fi->index;
+          }
+        }
+      }
+      npactive = kept;
+      factive[nfactive++] = f++;
+    }
+  }
+
+  // Annotate
+  for (p = 0; p < np; p++) {
+    if (best[p] >= 0) {
+      profile_struct_annotation* profile = &d->profiles[d->pitems[g->pfirst + p].index];
+      strncpy(profile->annotation, d->features[best[p]].name, MAX_FEATURE);
+      profile->anscore = score[p];
+      profile->category = KNOWN;
+    }
+  }
+
+  free(pactive);
+  free(factive);
+  free(best);
+  free(score);
+}
+
+/*
+ * sweep_annotate
+ *
+ * @see include/annotate/sweep.h
+ */
+void sweep_annotate(args_a_struct* arguments, profile_struct_annotation* profiles, int nprofiles, feature_struct* features, long nfeatures)
+{
+  sweep_struct sweep;
+  sweepitem_struct *pitems, *fitems;
+  sweepgroup_struct* groups;
+  chrdict_struct chromosomes;
+  long i, f, ngroups;
+
+  pitems = (sweepitem_struct*) malloc(MAX(nprofiles, 1) * sizeof(sweepitem_struct));
+  fitems = (sweepitem_struct*) malloc(MAX(nfeatures, 1) * sizeof(sweepitem_struct));
+  groups = (sweepgroup_struct*) malloc(MAX(nprofiles, 1) * sizeof(sweepgroup_struct));
+
+  // Chromosomes are interned once, so items are sorted and grouped by integer identifiers.
+  // Features on chromosomes without profiles get -1 and are never swept.
+  chrdict_init(&chromosomes);
+  for (i = 0; i < nprofiles; i++) {
+    pitems[i].chromosome = chrdict_intern(&chromosomes, profiles[i].chromosome);
+    pitems[i].strand = profiles[i].strand;
+    pitems[i].start = profiles[i].start;
+    pitems[i].end = profiles[i].end;
+    pitems[i].index = i;
+  }
+  for (i = 0; i < nfeatures; i++) {
+    fitems[i].chromosome = chrdict_find(&chromosomes, features[i].chromosome);
+    fitems[i].strand = features[i].strand;
+    fitems[i].start = features[i].start;
+    fitems[i].end = features[i].end;
+    fitems[i].index = i;
+  }
+  qsort(pitems, nprofiles, sizeof(sweepitem_struct), cmpsweep);
+  qsort(fitems, nfeatures, sizeof(sweepitem_struct), cmpsweep);
+
+  // One group per chromosome and strand with profiles, along with its features
+  ngroups = 0;
+  f = 0;
+  for (i = 0; i < nprofiles; ) {
+    long j = i;
+    while ((j < nprofiles) && (cmplocation(&pitems[i], &pitems[j]) == 0)) j++;
+    while ((f < nfeatures) && (cmplocation(&fitems[f], &pitems[i]) < 0)) f++;
+    groups[ngroups].pfirst = i;
+    groups[ngroups].plast = j;
+    groups[ngroups].ffirst = f;
+    while ((f < nfeatures) && (cmplocation(&fitems[f], &pitems[i]) == 0)) f++;
+    groups[ngroups].flast = f;
+    groups[ngroups].cost = (j - i) + (groups[ngroups].flast - groups[ngroups].ffirst);
+    if (groups[ngroups].flast > groups[ngroups].ffirst)
+      ngroups++;
+    i = j;
+  }
+  qsort(groups, ngroups, sizeof(sweepgroup_struct), cmpgroup);
+
+  sweep.arguments = arguments;
+  sweep.profiles = profiles;
+  sweep.features = features;
+  sweep.pitems = pitems;
+  sweep.fitems = fitems;
+  sweep.groups = groups;
+  parallel_for(ngroups, arguments->threads, 1, sweep_task, &sweep);
+
+  free(pitems);
+  free(fitems);
+  free(groups);
+  chrdict_destroy(&chromosomes);
+}
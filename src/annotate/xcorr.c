@@ -1,5 +1,67 @@
 #include <annotate/xcorr.h>
 
+/*
+ * xcorr_direct
+ *   Cross-correlation of the short signal y against the long signal x for lags 0 to nlags - 1.
+ *   The inner loop is a plain dot product so that it is vectorized by the compiler.
+ */
+void xcorr_direct(const double* restrict x, const double* restrict y, int ny, int nlags, double* restrict rxy)
+{
+  int lag, j;
+
+  for (lag = 0; lag < nlags; lag++) {
+    const double* xl = x + lag;
+    double sum = 0;
+    for (j = 0; j < ny; j++)
+      sum += xl[j] * y[j];
+    rxy[lag] = sum;
+  }
+}
+
+/*
+ * xcorr_fft
+ *   Same as xcorr_direct through the product of the spectra of x and y.
+ *   Signals are zero-padded to a power of two >= nx, so the circular lags 0 to nx - ny do not wrap.
+ *
+ * @return
+ *   0 if success. -1 if there is not enough memory.
+ */
+int xcorr_fft(const double* x, int nx, const double* y, int ny, int nlags, double* rxy)
+{
+  double *fx, *fy;
+  size_t size;
+  int i;
+
+  size = 1;
+  while (size < (size_t) nx)
+    size <<= 1;
+
+  fx = (double*) calloc(4 * size, sizeof(double));
+  if (fx == NULL)
+    return(-1);
+  fy = fx + 2 * size;
+
+  for (i = 0; i < nx; i++) fx[2 * i] = x[i];
+  for (i = 0; i < ny; i++) fy[2 * i] = y[i];
+  gsl_fft_complex_radix2_forward(fx, 1, size);
+  gsl_fft_complex_radix2_forward(fy, 1, size);
+
+  // X * conj(Y)
+  for (i = 0; i < (int) size; i++) {
+    double re = fx[2 * i] * fy[2 * i] + fx[2 * i + 1] * fy[2 * i + 1];
+    double im = fx[2 * i + 1] * fy[2 * i] - fx[2 * i] * fy[2 * i + 1];
+    fx[2 * i] = re;
+    fx[2 * i + 1] = im;
+  }
+  gsl_fft_complex_radix2_inverse(fx, 1, size);
+
+  for (i = 0; i < nlags; i++)
+    rxy[i] = fx[2 * i];
+
+  free(fx);
+  return(0);
+}
+
 /*
  * nxcorr
  *
@@ -7,95 +69,56 @@
  */
 double nxcorr(profile_struct_annotation* p1, profile_struct_annotation* p2)
 {
-  int index, lag, i, j, length;
-  double rxx = 0, ryy = 0, rxy = 0, rnm, noise, nrxy;
-  double* corr;
+  profile_struct_annotation *px, *py;
+  double noise[MAX_PROFILE_LENGTH];
+  double nn[MAX_PROFILE_LENGTH + 1], xn[MAX_PROFILE_LENGTH + 1];
+  double rxy[MAX_PROFILE_LENGTH];
+  double rxx, ryy, best;
+  int nx, ny, nlags, lag, i;
 
-  srand(time(NULL));
-  index = 0;
-  length = abs(p1->length - p2->length) + 1;
-  corr = (double*) malloc(length * sizeof(double));
-
-  // profile1.length > profile2.length
-  if (p1->length > p2->length) {
-    for (i = 0; i < p1->length; i++)
-      rxx += p1->profile[i] * p1->profile[i];
-
-    for (lag = 0; lag < length; lag++) {
-      ryy = 0; rxy = 0; j = 0; i = 0;
-
-      while(i < lag) {
-        noise = p2->noise[rand() % MAX_PROFILE_LENGTH];
-        ryy += noise * noise;
-        rxy += p1->profile[i] * noise;
-        i++;
-      }
-      while(j < p2->length) {
-        ryy += p2->profile[j] * p2->profile[j];
-        rxy += p1->profile[i] * p2->profile[j];
-        i++; j++;
-      }
-      while(i < p1->length) {
-        noise = p2->noise[rand() % MAX_PROFILE_LENGTH];
-        ryy += noise * noise;
-        rxy += p1->profile[i] * noise;
-        i++;
-      }
-
-      rnm = sqrt(rxx * ryy);
-      corr[lag] = rxy / rnm;
-      if (corr[lag] > corr[index]) index = lag;
-    }
+  // x is the longest signal. Gaps of y are filled with its noise.
+  if (p1->length >= p2->length) {
+    px = p1;
+    py = p2;
   }
-
-  // profile1.length < profile2.length
-  else if (p1->length < p2->length) {
-    for (i = 0; i < p2->length; i++)
-      ryy += p2->profile[i] * p2->profile[i];
-
-    for (lag = 0; lag < length; lag++) {
-      rxx = 0; rxy = 0; j = 0; i = 0;
-
-      while(i < lag) {
-        noise = p1->noise[rand() % MAX_PROFILE_LENGTH];
-        rxx += noise * noise;
-        rxy += noise * p2->profile[i];
-        i++;
-      }
-      while(j < p1->length) {
-        rxx += p1->profile[j] * p1->profile[j];
-        rxy += p1->profile[j] * p2->profile[i];
-        i++; j++;
-      }
-      while(i < p2->length) {
-        noise = p1->noise[rand() % MAX_PROFILE_LENGTH];
-        rxx += noise * noise;
-        rxy += noise * p2->profile[i];
-        i++;
-      }
-
-      rnm = sqrt(rxx * ryy);
-      corr[lag] = rxy / rnm;
-      if (corr[lag] > corr[index]) index = lag;
-    }
+  else {
+    px = p2;
+    py = p1;
   }
+  nx = px->length;
+  ny = py->length;
+  nlags = nx - ny + 1;
 
-  // profile1.length == profile2.length
-  else {
-    i = 0; j = 0;
-    while(i < p1->length) {
-      rxx += p1->profile[i] * p1->profile[i];
-      ryy += p2->profile[i] * p2->profile[i];
-      rxy += p1->profile[i] * p2->profile[i];
-      i++;
-    }
-    rnm = sqrt(rxx * ryy);
-    corr[0] = rxy / rnm;
-    index = 0;
+  // Noise drawn once per position of x
+  // Prefix sums of the noise energy and of the cross products of x and noise
+  srand(time(NULL));
+  nn[0] = xn[0] = 0;
+  for (i = 0; i < nx; i++) {
+    noise[i] = (nlags > 1) ? py->noise[rand() % MAX_PROFILE_LENGTH] : 0;
+    nn[i + 1] = nn[i] + noise[i] * noise[i];
+    xn[i + 1] = xn[i] + px->profile[i] * noise[i];
   }
 
-  nrxy = corr[index];
-  free(corr);
+  rxx = 0;
+  for (i = 0; i < nx; i++)
+    rxx += px->profile[i] * px->profile[i];
+  ryy = 0;
+  for (i = 0; i < ny; i++)
+    ryy += py->profile[i] * py->profile[i];
+
+  // Cross-correlation of the overlapping part for all lags
+  if ((nx < XCORR_FFT_LENGTH) || (xcorr_fft(px->profile, nx, py->profile, ny, nlags, rxy) < 0))
+    xcorr_direct(px->profile, py->profile, ny, nlags, rxy);
+
+  // Noise before and after the overlap comes from the prefix sums
+  best = 0;
+  for (lag = 0; lag < nlags; lag++) {
+    double r = rxy[lag] + xn[lag] + (xn[nx] - xn[lag + ny]);
+    double e = ryy + nn[lag] + (nn[nx] - nn[lag + ny]);
+    double corr = r / sqrt(rxx * e);
+    if ((lag == 0) || (corr > best))
+      best = corr;
+  }
 
-  return(nrxy);
+  return(best);
 }
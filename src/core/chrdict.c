@@ -0,0 +1,137 @@
+#include <core/chrdict.h>
+
+/*
+ * chrdict_hash
+ *   FNV-1a hash of a chromosome name
+ */
+unsigned int chrdict_hash(const char* name)
+{
+  unsigned int h = 2166136261u;
+
+  for (; *name != '\0'; name++) {
+    h ^= (unsigned char) *name;
+    h *= 16777619u;
+  }
+
+  return(h);
+}
+
+/*
+ * chrdict_slot
+ *   Slot of a name in the open addressing table (linear probing).
+ *   It is either the slot holding the name or the empty slot where it would be inserted.
+ */
+int chrdict_slot(const chrdict_struct* dict, const char* name)
+{
+  int mask = dict->capacity - 1;
+  int slot = chrdict_hash(name) & mask;
+
+  while ((dict->slots[slot] >= 0) && (strcmp(dict->names[dict->slots[slot]], name) != 0))
+    slot = (slot + 1) & mask;
+
+  return(slot);
+}
+
+/*
+ * chrdict_grow
+ *   Doubles the number of slots of the table and rehashes the names
+ *
+ * @return
+ *   0 if success. -1 if there is not enough memory.
+ */
+int chrdict_grow(chrdict_struct* dict)
+{
+  int capacity = (dict->capacity == 0) ? CHRDICT_CAPACITY : 2 * dict->capacity;
+  char (*names)[MAX_FEATURE];
+  int* slots;
+  int i;
+
+  if ((slots = (int*) malloc(capacity * sizeof(int))) == NULL)
+    return(-1);
+  if ((names = realloc(dict->names, (capacity / 2) * sizeof(*names))) == NULL) {
+    free(slots);
+    return(-1);
+  }
+
+  free(dict->slots);
+  dict->names = names;
+  dict->slots = slots;
+  dict->capacity = capacity;
+  for (i = 0; i < capacity; i++)
+    dict->slots[i] = -1;
+  for (i = 0; i < dict->size; i++)
+    dict->slots[chrdict_slot(dict, dict->names[i])] = i;
+
+  return(0);
+}
+
+/*
+ * chrdict_init
+ *
+ * @see include/core/chrdict.h
+ */
+void chrdict_init(chrdict_struct* dict)
+{
+  dict->names = NULL;
+  dict->slots = NULL;
+  dict->size = 0;
+  dict->capacity = 0;
+}
+
+/*
+ * chrdict_find
+ *
+ * @see include/core/chrdict.h
+ */
+int chrdict_find(const chrdict_struct* dict, const char* name)
+{
+  if (dict->capacity == 0)
+    return(-1);
+
+  return(dict->slots[chrdict_slot(dict, name)]);
+}
+
+/*
+ * chrdict_intern
+ *
+ * @see include/core/chrdict.h
+ */
+int chrdict_intern(chrdict_struct* dict, const char* name)
+{
+  int slot;
+
+  // Table is kept at most half full
+  if ((2 * (dict->size + 1) > dict->capacity) && (chrdict_grow(dict) < 0))
+    return(-1);
+
+  slot = chrdict_slot(dict, name);
+  if (dict->slots[slot] < 0) {
+    strncpy(dict->names[dict->size], name, MAX_FEATURE - 1);
+    dict->names[dict->size][MAX_FEATURE - 1] = '\0';
+    dict->slots[slot] = dict->size++;
+  }
+
+  return(dict->slots[slot]);
+}
+
+/*
+ * chrdict_name
+ *
+ * @see include/core/chrdict.h
+ */
+const char* chrdict_name(const chrdict_struct* dict, int id)
+{
+  return(dict->names[id]);
+}
+
+/*
+ * chrdict_destroy
+ *
+ * @see include/core/chrdict.h
+ */
+void chrdict_destroy(chrdict_struct* dict)
+{
+  free(dict->names);
+  free(dict->slots);
+  chrdict_init(dict);
+}
@@ -0,0 +1,119 @@
+#include <core/parallel.h>
+
+/*
+ * Struct shared by the workers of a parallel_for call
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  int next;
+  int n;
+  int chunk;
+  parallel_task task;
+  void* data;
+} parallel_struct;
+
+/*
+ * Struct handed to each worker thread
+ */
+typedef struct {
+  parallel_struct* shared;
+  int thread;
+} worker_struct;
+
+/*
+ * parallel_worker
+ *   Worker loop. Grabs chunks of iterations until the range is exhausted.
+ *
+ * @arg void* arg
+ *   Pointer to a worker_struct
+ */
+void* parallel_worker(void* arg)
+{
+  worker_struct* worker = (worker_struct*) arg;
+  parallel_struct* shared = worker->shared;
+  int i, start, stop;
+
+  while (1) {
+    pthread_mutex_lock(&shared->lock);
+    start = shared->next;
+    shared->next += shared->chunk;
+    pthread_mutex_unlock(&shared->lock);
+
+    if (start >= shared->n)
+      break;
+
+    stop = MIN(start + shared->chunk, shared->n);
+    for (i = start; i < stop; i++)
+      shared->task(i, worker->thread, shared->data);
+  }
+
+  return(NULL);
+}
+
+/*
+ * parallel_threads
+ *
+ * @see include/core/parallel.h
+ */
+int parallel_threads(int n, int nthreads)
+{
+  if (nthreads > n) nthreads = n;
+  if (nthreads < 1) nthreads = 1;
+  return(nthreads);
+}
+
+/*
+ * parallel_for
+ *
+ * @see include/core/parallel.h
+ */
+void parallel_for(int n, int nthreads, int chunk, parallel_task task, void* data)
+{
+  parallel_struct shared;
+  worker_struct* workers;
+  pthread_t* threads;
+  pthread_attr_t attr;
+  int i, started;
+
+  nthreads = parallel_threads(n, nthreads);
+
+  // Serial execution
+  if (nthreads == 1) {
+    for (i = 0; i < n; i++)
+      task(i, 0, data);
+    return;
+  }
+
+  // Initialize shared state
+  pthread_mutex_init(&shared.lock, NULL);
+  shared.next = 0;
+  shared.n = n;
+  shared.chunk = MAX(chunk, 1);
+  shared.task = task;
+  shared.data = data;
+  threads = (pthread_t*) malloc(nthreads * sizeof(pthread_t));
+  workers = (worker_struct*) malloc(nthreads * sizeof(worker_struct));
+
+  // Launch workers. The calling thread acts as worker 0.
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, THREAD_STACK_SIZE);
+  started = 1;
+  for (i = 1; i < nthreads; i++) {
+    workers[i].shared = &shared;
+    workers[i].thread = i;
+    if (pthread_create(&threads[i], &attr, parallel_worker, &workers[i]) != 0)
+      break;
+    started++;
+  }
+  pthread_attr_destroy(&attr);
+  workers[0].shared = &shared;
+  workers[0].thread = 0;
+  parallel_worker(&workers[0]);
+
+  // Wait for workers and free structures
+  for (i = 1; i < started; i++)
+    pthread_join(threads[i], NULL);
+  pthread_mutex_destroy(&shared.lock);
+  free(threads);
+  free(workers);
+}
@@ -0,0 +1,179 @@
+#include <core/quantile.h>
+
+/*
+ * double comparison function for qsort
+ */
+int cmpq(const void *x, const void *y)
+{
+  double xx = *(double*)x, yy = *(double*)y;
+  if (xx < yy) return -1;
+  if (xx > yy) return  1;
+  return 0;
+}
+
+/*
+ * introselect
+ *   Reorders data so that data[k] is the element that would be in position k if data
+ *   were sorted, all the elements before it are <= and all the elements after it are >=
+ *
+ * @arg double* data
+ *   Array of values
+ * @arg long n
+ *   Number of elements in data
+ * @arg long k
+ *   Position to select
+ */
+void introselect(double* data, long n, long k)
+{
+  long left, right, i, j, depth;
+  double pivot, tmp;
+
+  left = 0;
+  right = n - 1;
+  depth = 0;
+  for (i = n; i > 1; i >>= 1) depth += 2;
+
+  while (right > left) {
+
+    // Too many bad pivots. Sort what remains.
+    if (depth-- == 0) {
+      qsort(data + left, right - left + 1, sizeof(double), cmpq);
+      return;
+    }
+
+    // Median of three pivot
+    i = left + (right - left) / 2;
+    if (data[i] < data[left]) { tmp = data[i]; data[i] = data[left]; data[left] = tmp; }
+    if (data[right] < data[left]) { tmp = data[right]; data[right] = data[left]; data[left] = tmp; }
+    if (data[right] < data[i]) { tmp = data[right]; data[right] = data[i]; data[i] = tmp; }
+    pivot = data[i];
+
+    // Hoare partition
+    i = left;
+    j = right;
+    while (i <= j) {
+      while (data[i] < pivot) i++;
+      while (data[j] > pivot) j--;
+      if (i <= j) {
+        tmp = data[i]; data[i] = data[j]; data[j] = tmp;
+        i++;
+        j--;
+      }
+    }
+
+    if (k <= j) right = j;
+    else if (k >= i) left = i;
+    else return;
+  }
+}
+
+/*
+ * quantile_select
+ *
+ * @see include/core/quantile.h
+ */
+double quantile_select(double* data, long n, double f)
+{
+  double index, delta, next;
+  long lhs, i;
+
+  if (n == 0) return(0.0);
+
+  index = f * (n - 1);
+  lhs = (long) index;
+  delta = index - lhs;
+
+  introselect(data, n, lhs);
+  if (lhs == n - 1) return(data[lhs]);
+
+  // The next order statistic is the minimum of the upper part
+  next = data[lhs + 1];
+  for (i = lhs + 2; i < n; i++)
+    if (data[i] < next) next = data[i];
+
+  return((1 - delta) * data[lhs] + delta * next);
+}
+
+/*
+ * quantile_pairs
+ *
+ * @see include/core/quantile.h
+ */
+double quantile_pairs(double** dist, int n, double f, double* lower, double* max)
+{
+  double min, width, index, delta, *gathered, result;
+  long npairs, lhs, rhs, below, ngathered, cumulative;
+  long *histogram;
+  int i, j, bin, first, last;
+
+  npairs = (long) n * (n - 1) / 2;
+  index = f * (npairs - 1);
+  lhs = (long) index;
+  delta = index - lhs;
+  rhs = (lhs == npairs - 1) ? lhs : lhs + 1;
+
+  // Extremes
+  min = DBL_MAX;
+  *max = -DBL_MAX;
+  *lower = DBL_MAX;
+  for (i = 0; i < n; i++) {
+    for (j = i + 1; j < n; j++) {
+      if (dist[i][j] < min) min = dist[i][j];
+      if (dist[i][j] > *max) *max = dist[i][j];
+      if ((dist[i][j] != 0) && (dist[i][j] < *lower)) *lower = dist[i][j];
+    }
+  }
+  if (min == *max) return(min);
+
+  // Histogram of the distances
+  histogram = (long*) calloc(QUANTILE_BINS, sizeof(long));
+  width = (*max - min) / QUANTILE_BINS;
+  for (i = 0; i < n; i++) {
+    for (j = i + 1; j < n; j++) {
+      bin = (int) ((dist[i][j] - min) / width);
+      if (bin >= QUANTILE_BINS) bin = QUANTILE_BINS - 1;
+      histogram[bin]++;
+    }
+  }
+
+  // Bins holding the ranks lhs and rhs
+  first = last = -1;
+  below = cumulative = 0;
+  for (bin = 0; bin < QUANTILE_BINS; bin++) {
+    if ((first < 0) && (cumulative + histogram[bin] > lhs)) {
+      first = bin;
+      below = cumulative;
+    }
+    cumulative += histogram[bin];
+    if (cumulative > rhs) {
+      last = bin;
+      break;
+    }
+  }
+  ngathered = cumulative - below;
+  free(histogram);
+
+  // Gather the distances in those bins and select
+  gathered = (double*) malloc(ngathered * sizeof(double));
+  ngathered = 0;
+  for (i = 0; i < n; i++) {
+    for (j = i + 1; j < n; j++) {
+      bin = (int) ((dist[i][j] - min) / width);
+      if (bin >= QUANTILE_BINS) bin = QUANTILE_BINS - 1;
+      if ((bin >= first) && (bin <= last)) gathered[ngathered++] = dist[i][j];
+    }
+  }
+
+  introselect(gathered, ngathered, lhs - below);
+  result = gathered[lhs - below];
+  if (delta > 0) {
+    double next = DBL_MAX;
+    long k;
+    for (k = lhs - below + 1; k < ngathered; k++)
+      if (gathered[k] < next) next = gathered[k];
+    result = (1 - delta) * result + delta * next;
+  }
+
+  free(gathered);
+  return(result);
+}
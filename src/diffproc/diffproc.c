@@ -13,34 +13,277 @@ int cmpds(const void *x, const void *y)
 
 
 /*
- * add_profile
- *   Inserts a profile into the array of profile structs
+ * Job of the parallel distance calculations
+ *   intra-cluster : row of the pairwise distances of a cluster (profile index against the next ones)
+ *   assessment    : profile index of a cluster of condition A against the cluster of its partner
+ */
+typedef struct {
+  int condition;
+  int cluster;
+  int index;
+  long cost;
+} dpjob_struct;
+
+/*
+ * Result of the differential processing assessment of a profile in condition A
+ */
+typedef struct {
+  int adpc;
+  int pdcp;
+  double fold_b;
+  double fold_a;
+  int tda;
+  int tdb;
+} assessment_struct;
+
+/*
+ * Struct shared by the distance tasks
+ *   loaded : whether the profiles of a cluster are loaded from its profile file
+ *   needed : last batch of clusters of condition A that has asked for a cluster
+ *   until  : last batch of clusters of condition A that needs a cluster, after which it is released
+ */
+typedef struct {
+  profile_struct_diffproc** condition[2];
+  int* condition_n[2];
+  double** intra[2];
+  int* loaded[2];
+  int* needed[2];
+  int* until[2];
+  dpjob_struct* jobs;
+  assessment_struct** assessments;
+  metric_struct* metric;
+  args_d_struct* arguments;
+} dpdist_struct;
+
+/*
+ * cmpjob
+ *   Comparison function to sort jobs by descending cost, so the largest ones are scheduled first
+ */
+int cmpjob(const void *x, const void *y)
+{
+  const dpjob_struct* xx = (const dpjob_struct*) x;
+  const dpjob_struct* yy = (const dpjob_struct*) y;
+
+  if (xx->cost > yy->cost) return -1;
+  if (xx->cost < yy->cost) return 1;
+  return 0;
+}
+
+
+/*
+ * Reference to a profile of a condition used to find partners.
+ * order is the position of the profile when traversing the clusters of its condition.
+ */
+typedef struct {
+  profile_struct_diffproc* profile;
+  int condition;
+  long order;
+} dpref_struct;
+
+/*
+ * cmpref
+ *   Comparison function to sort profile references by chromosome, strand and start
+ */
+int cmpref(const void *x, const void *y)
+{
+  const dpref_struct* xx = (const dpref_struct*) x;
+  const dpref_struct* yy = (const dpref_struct*) y;
+  int c;
+
+  if ((c = strcmp(xx->profile->chromosome, yy->profile->chromosome)) != 0) return c;
+  if (xx->profile->strand != yy->profile->strand) return (xx->profile->strand < yy->profile->strand) ? -1 : 1;
+  if (xx->profile->start != yy->profile->start) return (xx->profile->start < yy->profile->start) ? -1 : 1;
+  if (xx->condition != yy->condition) return (xx->condition < yy->condition) ? -1 : 1;
+  if (xx->order < yy->order) return -1;
+  if (xx->order > yy->order) return 1;
+  return 0;
+}
+
+
+/*
+ * find_partners
+ *   Pairs the profiles of both conditions that overlap on the same chromosome and strand.
+ *   Profiles of both conditions are sorted by chromosome, strand and start and swept once,
+ *   keeping the profiles of each condition that can still overlap the next ones.
+ *   A profile keeps as partner the overlapping profile of the other condition that comes
+ *   last in the order of the clusters.
+ */
+void find_partners(profile_struct_diffproc** cond_a, int* cond_a_n, int nclusters_a, profile_struct_diffproc** cond_b, int* cond_b_n, int nclusters_b)
+{
+  dpref_struct* refs;
+  long *best, *active[2];
+  long nrefs, nactive[2], r, k, n;
+  int c, i, j;
+
+  // References to the profiles of both conditions
+  n = 0;
+  for (i = 0; i < nclusters_a; i++) n += cond_a_n[i];
+  for (i = 0; i < nclusters_b; i++) n += cond_b_n[i];
+  refs = (dpref_struct*) malloc(MAX(n, 1) * sizeof(dpref_struct));
+  best = (long*) malloc(MAX(n, 1) * sizeof(long));
+  active[0] = (long*) malloc(MAX(n, 1) * sizeof(long));
+  active[1] = (long*) malloc(MAX(n, 1) * sizeof(long));
+
+  nrefs = 0;
+  for (c = 0; c < 2; c++) {
+    long order = 0;
+    for (i = 0; i < (c ? nclusters_b : nclusters_a); i++) {
+      for (j = 0; j < (c ? cond_b_n[i] : cond_a_n[i]); j++) {
+        refs[nrefs].profile = c ? &cond_b[i][j] : &cond_a[i][j];
+        refs[nrefs].condition = c;
+        refs[nrefs].order = order++;
+        nrefs++;
+      }
+    }
+  }
+  qsort(refs, nrefs, sizeof(dpref_struct), cmpref);
+
+  // Sweep
+  nactive[0] = nactive[1] = 0;
+  for (r = 0; r < nrefs; r++) {
+    profile_struct_diffproc* p = refs[r].profile;
+    int other = 1 - refs[r].condition;
+    long kept = 0;
+
+    best[r] = -1;
+
+    // New chromosome or strand
+    if ((r > 0) && ((strcmp(p->chromosome, refs[r - 1].profile->chromosome) != 0) || (p->strand != refs[r - 1].profile->strand)))
+      nactive[0] = nactive[1] = 0;
+
+    // Profiles of the other condition that end before this one starts cannot overlap anymore
+    for (k = 0; k < nactive[other]; k++) {
+      long o = active[other][k];
+      if (refs[o].profile->end < p->start)
+        continue;
+      active[other][kept++] = o;
+
+      if (refs[o].order > best[r]) {
+        best[r] = refs[o].order;
+        p->partner = refs[o].profile;
+      }
+      if (refs[r].order > best[o]) {
+        best[o] = refs[r].order;
+        refs[o].profile->partner = p;
+      }
+    }
+    nactive[other] = kept;
+    active[refs[r].condition][nactive[refs[r].condition]++] = r;
+  }
+
+  free(refs);
+  free(best);
+  free(active[0]);
+  free(active[1]);
+}
+
+
+/*
+ * as_annotation
+ *   Fills an annotation profile with the signal of a differential processing profile
+ */
+void as_annotation(profile_struct_diffproc* pd, profile_struct_annotation* pa)
+{
+  pa->profile = pd->profile;
+  pa->length = pd->length;
+  pa->max_height = gsl_stats_max(pd->profile, 1, pd->length);
+  memcpy(pa->noise, pd->noise, MAX_PROFILE_LENGTH * sizeof(double));
+}
+
+
+/*
+ * distance_dp
+ *   Distance between two differential processing profiles through the metric.
+ *   Negative correlations are clipped to 0.
+ */
+double distance_dp(metric_struct* metric, profile_struct_diffproc* p1, profile_struct_diffproc* p2, double bound)
+{
+  profile_struct_annotation pa, pb;
+  double xcr;
+
+  as_annotation(p1, &pa);
+  as_annotation(p2, &pb);
+  xcr = metric_correlation(metric, &pa, p1->features, &pb, p2->features, bound);
+  if (xcr < 0) xcr = 0;
+
+  return(1 - xcr);
+}
+
+
+/*
+ * insert_profile
+ *   Inserts the location of a profile into the array of profile structs.
+ *   Heights are loaded later with the rest of its cluster.
  */
 void insert_profile(profile_struct_diffproc** condition, int* condition_n, profile_struct_diffproc profile, feature_struct_diffproc feature)
 {
-  int i, j, k;
+  int i, j;
   
   i = feature.cluster - 1;
   j = condition_n[feature.cluster - 1];
 
-  condition[i][j].profile = (double*) malloc(profile.length * sizeof(double));
-  for (k = 0; k < profile.length; k++) condition[i][j].profile[k] = profile.profile[k];
-  strncpy(condition[i][j].chromosome, profile.chromosome, MAX_FEATURE);
-  condition[i][j].start = profile.start;
-  condition[i][j].end = profile.end;
-  condition[i][j].length = profile.length;
-  condition[i][j].strand = profile.strand;
+  condition[i][j] = profile;
   strncpy(condition[i][j].annotation, feature.name, MAX_FEATURE);
-  for (k = 0; k < MAX_PROFILE_LENGTH; k++) condition[i][j].noise[k] = profile.noise[k];
   condition[i][j].cluster = feature.cluster;
   condition[i][j].position = j;
-  condition[i][j].differential = 0;
-  condition[i][j].partner = NULL;
 
   condition_n[feature.cluster - 1]++;
 }
 
 
+/*
+ * load_cluster
+ *   Reads the heights of the profiles of a cluster from their profile file and precomputes their metric features
+ *
+ * @return
+ *   0 if success. -1 if the profile file is ill-formatted or does not match the location of the profiles.
+ */
+int load_cluster(FILE* fp, profile_struct_diffproc* cluster, int n, metric_struct* metric)
+{
+  profile_struct_diffproc profile;
+  profile_struct_annotation pa;
+  int k;
+
+  for (k = 0; k < n; k++) {
+    if ((fseek(fp, cluster[k].offset, SEEK_SET) != 0) || (next_diffproc_profile(fp, &profile) <= 0))
+      return(-1);
+    if ((profile.start != cluster[k].start) || (profile.end != cluster[k].end)) {
+      free(profile.profile);
+      free(profile.noise);
+      return(-1);
+    }
+    cluster[k].profile = profile.profile;
+    cluster[k].noise = profile.noise;
+    cluster[k].features = (features_struct*) malloc(sizeof(features_struct));
+
+    pa.profile = cluster[k].profile;
+    pa.length = cluster[k].length;
+    metric_prepare(metric, &pa, cluster[k].features);
+  }
+
+  return(0);
+}
+
+
+/*
+ * release_cluster
+ *   Frees the heights, noise and features of the profiles of a cluster
+ */
+void release_cluster(profile_struct_diffproc* cluster, int n)
+{
+  int k;
+
+  for (k = 0; k < n; k++) {
+    free(cluster[k].profile);
+    free(cluster[k].noise);
+    free(cluster[k].features);
+    cluster[k].profile = NULL;
+    cluster[k].noise = NULL;
+    cluster[k].features = NULL;
+  }
+}
+
+
 /*
  * assess_dp_p
  *
@@ -107,6 +350,171 @@ int assess_dp_p(double* a, int n, double* ba, int mn, double* b, int m, double*
 }
 
 
+/*
+ * load_intra
+ *   Reads the pairwise distances between the profiles of a condition, as written by annotate
+ *   in the same order as the profiles, and keeps the distances between profiles of the same cluster.
+ *   Distances between profiles of the same cluster must have been measured.
+ *
+ * @arg FILE* file
+ *   Distance file
+ * @arg int nprofiles
+ *   Number of profiles of the condition
+ * @arg int* clusters
+ *   Cluster (0-based) of every profile, in the order of the profiles file
+ * @arg int* cluster_n
+ *   Number of profiles per cluster
+ * @arg int nclusters
+ *   Number of clusters
+ * @arg double** intra
+ *   Intra-cluster distances of every cluster, where results will be stored
+ *
+ * @return
+ *   0 if success. -1 if the file is ill-formatted or does not match the profiles.
+ *   -2 if a distance between profiles of the same cluster was not measured.
+ */
+int load_intra(FILE* file, int nprofiles, int* clusters, int* cluster_n, int nclusters, double** intra)
+{
+  long* fill;
+  double score;
+  int i, j, result;
+
+  fill = (long*) calloc(MAX(nclusters, 1), sizeof(long));
+  i = 0; j = 1;
+  while ((result = next_correlation(file, &score)) > 0) {
+    if (i >= nprofiles - 1) {
+      result = -1;
+      break;
+    }
+    if ((clusters[i] == clusters[j]) && (result == 2)) {
+      result = -2;
+      break;
+    }
+    if (clusters[i] == clusters[j])
+      intra[clusters[i]][fill[clusters[i]]++] = score;
+    j++;
+    if (j == nprofiles) {
+      i++;
+      j = i + 1;
+    }
+  }
+
+  // All the pairs must be in the file
+  if ((result == 0) && (nprofiles > 1) && (i < nprofiles - 1))
+    result = -1;
+  for (i = 0; (result == 0) && (i < nclusters); i++)
+    if (fill[i] != ((long) (cluster_n[i] - 1) * cluster_n[i]) / 2)
+      result = -1;
+
+  free(fill);
+  return(result);
+}
+
+
+/*
+ * intra_task
+ *   Distances between a profile and the next profiles of its cluster.
+ *   Row j of a cluster of n profiles starts at j * (n - 1) - j * (j - 1) / 2 in the intra-cluster array.
+ */
+void intra_task(int index, int thread, void* data)
+{
+  dpdist_struct* d = (dpdist_struct*) data;
+  dpjob_struct* job = &d->jobs[index];
+  profile_struct_diffproc* cluster = d->condition[job->condition][job->cluster];
+  int nc = d->condition_n[job->condition][job->cluster];
+  long j = job->index;
+  double* row = d->intra[job->condition][job->cluster] + (j * (nc - 1) - (j * (j - 1)) / 2);
+  int k;
+
+  for (k = j + 1; k < nc; k++)
+    row[k - j - 1] = distance_dp(d->metric, &cluster[j], &cluster[k], -INFINITY);
+}
+
+
+/*
+ * sort_task
+ *   Sorts the intra-cluster distances of a cluster
+ */
+void sort_task(int index, int thread, void* data)
+{
+  dpdist_struct* d = (dpdist_struct*) data;
+  dpjob_struct* job = &d->jobs[index];
+  long nc = d->condition_n[job->condition][job->cluster];
+
+  qsort(d->intra[job->condition][job->cluster], ((nc - 1) * nc) / 2, sizeof(double), cmpds);
+}
+
+
+/*
+ * assess_task
+ *   Assesses the differential processing of a profile in condition A against its partner in condition B
+ */
+void assess_task(int index, int thread, void* data)
+{
+  dpdist_struct* d = (dpdist_struct*) data;
+  dpjob_struct* job = &d->jobs[index];
+  assessment_struct* result = &d->assessments[job->cluster][job->index];
+  profile_struct_diffproc* pda = &d->condition[0][job->cluster][job->index];
+  int i, j, k;
+
+  i = job->cluster;
+  j = pda->partner->cluster - 1;
+
+  int tda = ((d->condition_n[0][i] - 1) * d->condition_n[0][i]) / 2;
+  int tdb = ((d->condition_n[1][j] - 1) * d->condition_n[1][j]) / 2;
+  int tdab = d->condition_n[1][j];
+  int tdba = d->condition_n[0][i];
+  profile_struct_diffproc* pdb = pda->partner;
+
+  // Calculate distance between same profile
+  double pxcr = distance_dp(d->metric, pda, pdb, -INFINITY);
+
+  // Calculate profile in A against cluster in B
+  // Negative correlations are clipped to 0, so alignments that cannot reach 0 are abandoned
+  double* interab = (double*) malloc(tdab * sizeof(double));
+  for (k = 0; k < tdab; k++)
+    interab[k] = distance_dp(d->metric, pda, &d->condition[1][j][k], 0);
+  qsort(interab, tdab, sizeof(double), cmpds);
+
+  // Calculate profile in B against cluster in A
+  double* interba = (double*) malloc(tdba * sizeof(double));
+  for (k = 0; k < tdba; k++)
+    interba[k] = distance_dp(d->metric, &d->condition[0][i][k], pdb, 0);
+  qsort(interba, tdba, sizeof(double), cmpds);
+
+  // Assess differential processing of profile in A against cluster in B
+  // Assess differential processing of profile in B against cluster in A
+  result->adpc = assess_dp_p(d->intra[0][i], tda, interba, tdba, d->intra[1][j], tdb, interab, tdab, d->arguments->pvalue);
+
+  // Assess magnitude of change
+  double mean_a = gsl_stats_median_from_sorted_data(d->intra[0][i], 1, tda);
+  double mean_b = gsl_stats_median_from_sorted_data(d->intra[1][j], 1, tdb);
+  result->pdcp = ((pxcr / mean_b) >= d->arguments->foldchange) && ((pxcr / mean_a) >= d->arguments->foldchange);
+  result->fold_b = pxcr / mean_b;
+  result->fold_a = pxcr / mean_a;
+  result->tda = tda;
+  result->tdb = tdb;
+
+  free(interab);
+  free(interba);
+}
+
+
+/*
+ * unload_cluster
+ *   Releases the profiles of a cluster and, unless they were read from a distance file, its intra-cluster distances
+ */
+void unload_cluster(dpdist_struct* d, int c, int i)
+{
+  release_cluster(d->condition[c][i], d->condition_n[c][i]);
+  if (!d->arguments->distances) {
+    free(d->intra[c][i]);
+    d->intra[c][i] = NULL;
+  }
+  d->loaded[c][i] = 0;
+}
+
+
 /*
  * Application entry point
  */
@@ -126,14 +534,27 @@ int diffproc_sc(int argc, char **argv)
   feature_struct_diffproc feature;         // Feature from the cluster file
   profile_struct_diffproc profile;         // Profile from the profile file
   int *cond_a_n, *cond_b_n;                // Array with numbers of profiles per cluster for conditions A and B
-  int i, j, k;                             // General purpose variables
+  int i, j;                                // General purpose variables
   double** intra_a;                        // Intracluster distances for condition A
   double** intra_b;                        // Intracluster distances for condition B
   char strands[2][2] = {"+\0", "-\0"};     // Array for printing strand
-
+  metric_struct* metric;                   // Distance metric between profiles
+  dpdist_struct dist;                      // Shared data of the parallel distance calculations
+  dpjob_struct* jobs;                      // Jobs of the parallel distance calculations
+  long njobs;                              // Number of jobs
+  dpjob_struct* loads;                     // Clusters loaded for a batch
+  long nloads;                             // Number of clusters loaded for a batch
+  assessment_struct** assessments;         // Differential processing assessment of the profiles in condition A
+  int c;                                   // Condition index
+  int *lines_a, *lines_b;                  // Cluster of every profile in the order of the files for conditions A and B
+  int batch, first, last;                  // Clusters of condition A assessed at once
   // Initialize options with default values
   arguments.pvalue = (double) P_VALUE;
   arguments.foldchange = (double) DP_FOLD_CHANGE;
+  arguments.metric = metric_find(DISTANCE_METRIC);
+  arguments.threads = THREADS;
+  arguments.distances = 0;
+  arguments.streaming = 0;
 
   // Parse command line
   // Exit if command is not well-formed
@@ -144,6 +565,7 @@ int diffproc_sc(int argc, char **argv)
     fprintf(stderr, "%s\n", ERR_DIFFPROC_HELP_MSG);
     return(1);
   }
+  metric = metric_get(arguments.metric);
 
   // Open clusters file from condition A and check number of clusters
   // Exit if clusters file does not exist or is not readable
@@ -190,127 +612,133 @@ int diffproc_sc(int argc, char **argv)
   cond_b = (profile_struct_diffproc**) malloc(nclusters_b * sizeof(profile_struct_diffproc*));
   for (i = 0; i < nclusters_a; i++) cond_a[i] = (profile_struct_diffproc*) malloc(cond_a_n[i] * sizeof(profile_struct_diffproc));
   for (i = 0; i < nclusters_b; i++) cond_b[i] = (profile_struct_diffproc*) malloc(cond_b_n[i] * sizeof(profile_struct_diffproc));
+  for (i = 0, nprofiles_a = 0; i < nclusters_a; i++) nprofiles_a += cond_a_n[i];
+  for (i = 0, nprofiles_b = 0; i < nclusters_b; i++) nprofiles_b += cond_b_n[i];
+  lines_a = (int*) malloc(MAX(nprofiles_a, 1) * sizeof(int));
+  lines_b = (int*) malloc(MAX(nprofiles_b, 1) * sizeof(int));
   for (i = 0; i < nclusters_a; i++) cond_a_n[i] = 0;
   for (i = 0; i < nclusters_b; i++) cond_b_n[i] = 0;
 
-  // Simultaneously open clusters and profile files from condition A. Read and store data.
+  // Open profile files. They are kept open to load the heights of the clusters when they are needed.
+  profiles_a_file = fopen(arguments.profiles_a_f_path, "r");
+  if (!profiles_a_file) {
+    fprintf(stderr, "%s - %s\n", ERR_PROFILE_F_NOT_READABLE, arguments.profiles_a_f_path);
+    return(1);
+  }
+  profiles_b_file = fopen(arguments.profiles_b_f_path, "r");
+  if (!profiles_b_file) {
+    fprintf(stderr, "%s - %s\n", ERR_PROFILE_F_NOT_READABLE, arguments.profiles_b_f_path);
+    return(1);
+  }
+
+  // Simultaneously open clusters and profile files from condition A. Read and store the location of the profiles.
   fprintf(stderr, "[LOG] LOADING PROFILES FOR CONDITION A\n");
   nprofiles_a = 0;
   clusters_a_file = fopen(arguments.clusters_a_f_path, "r");
-  profiles_a_file = fopen(arguments.profiles_a_f_path, "r");
   result = 1;
   while(result > 0) {
     int r1 = next_diffproc_feature(clusters_a_file, &feature);
-    int r2 = next_diffproc_profile(profiles_a_file, &profile);
+    int r2 = next_diffproc_location(profiles_a_file, &profile);
     if (r1 > 0 && r2 > 0) {
+      lines_a[nprofiles_a] = feature.cluster - 1;
       insert_profile(cond_a, cond_a_n, profile, feature);
-      free(profile.profile);
       nprofiles_a++;
     }
     else
       result = MIN(r1, r2);
   }
   fclose(clusters_a_file);
-  fclose(profiles_a_file);
   fprintf(stderr, "[LOG]   %d profiles loaded\n", nprofiles_a);
 
-  // Simultaneously open clusters and profile files from condition B. Read and store data.
+  // Simultaneously open clusters and profile files from condition B. Read and store the location of the profiles.
   fprintf(stderr, "[LOG] LOADING PROFILES FOR CONDITION B\n");
   nprofiles_b = 0;
   clusters_b_file = fopen(arguments.clusters_b_f_path, "r");
-  profiles_b_file = fopen(arguments.profiles_b_f_path, "r");
   result = 1;
   while(result > 0) {
     int r1 = next_diffproc_feature(clusters_b_file, &feature);
-    int r2 = next_diffproc_profile(profiles_b_file, &profile);
+    int r2 = next_diffproc_location(profiles_b_file, &profile);
     if (r1 > 0 && r2 > 0) {
+      lines_b[nprofiles_b] = feature.cluster - 1;
       insert_profile(cond_b, cond_b_n, profile, feature);
-      free(profile.profile);
       nprofiles_b++;
     }
     else
       result = MIN(r1, r2);
   }
   fclose(clusters_b_file);
-  fclose(profiles_b_file);
   fprintf(stderr, "[LOG]   %d profiles loaded\n", nprofiles_b);
 
-  // Calculate intracluster distances for condition A
-  fprintf(stderr, "[LOG] CALCULATING INTRA CLUSTER DISTANCES FOR CONDITION A\n");
-  intra_a = (double**) malloc(nclusters_a * sizeof(double*));
-  for (i = 0; i < nclusters_a; i++) {
-    int nc = cond_a_n[i];
-    int td = ((nc - 1) * nc) / 2;
-    intra_a[i] = (double*) malloc (td * sizeof(double));
-    int idx = 0;
-    for (j = 0; j < (nc - 1); j++) {
-      profile_struct_annotation pa;
-      pa.profile = cond_a[i][j].profile;
-      int l;
-      for (l = 0; l < MAX_PROFILE_LENGTH; l++) pa.noise[l] = cond_a[i][j].noise[l];
-      pa.length = cond_a[i][j].length;
-      for (k = j + 1; k < nc; k++) {
-        profile_struct_annotation pb;
-        pb.profile = cond_a[i][k].profile;
-        for (l = 0; l < MAX_PROFILE_LENGTH; l++) pb.noise[l] = cond_a[i][k].noise[l];
-        pb.length = cond_a[i][k].length;
-        double xcr = xdtw(&pa, &pb);
-        if (xcr < 0) xcr = 0;
-        intra_a[i][idx] = 1 - xcr;
-        idx++;
+  // Intracluster distances for conditions A and B. Allocated when their clusters are loaded.
+  intra_a = (double**) calloc(MAX(nclusters_a, 1), sizeof(double*));
+  intra_b = (double**) calloc(MAX(nclusters_b, 1), sizeof(double*));
+  dist.condition[0] = cond_a;
+  dist.condition[1] = cond_b;
+  dist.condition_n[0] = cond_a_n;
+  dist.condition_n[1] = cond_b_n;
+  dist.intra[0] = intra_a;
+  dist.intra[1] = intra_b;
+  dist.loaded[0] = (int*) calloc(MAX(nclusters_a, 1), sizeof(int));
+  dist.loaded[1] = (int*) calloc(MAX(nclusters_b, 1), sizeof(int));
+  dist.needed[0] = (int*) calloc(MAX(nclusters_a, 1), sizeof(int));
+  dist.needed[1] = (int*) calloc(MAX(nclusters_b, 1), sizeof(int));
+  dist.until[0] = (int*) calloc(MAX(nclusters_a, 1), sizeof(int));
+  dist.until[1] = (int*) calloc(MAX(nclusters_b, 1), sizeof(int));
+  dist.metric = metric;
+  dist.arguments = &arguments;
+  dist.assessments = NULL;
+
+  jobs = (dpjob_struct*) malloc((nprofiles_a + nprofiles_b + nclusters_a + nclusters_b + 1) * sizeof(dpjob_struct));
+  loads = (dpjob_struct*) malloc((nclusters_a + nclusters_b + 1) * sizeof(dpjob_struct));
+  dist.jobs = jobs;
+  njobs = 0;
+
+  // Read them from the distance files computed by annotate if provided
+  // Distances of all the clusters are kept, since the files are not grouped by cluster
+  if (arguments.distances) {
+    fprintf(stderr, "[LOG] LOADING INTRA CLUSTER DISTANCES\n");
+    for (i = 0; i < nclusters_a; i++) intra_a[i] = (double*) malloc(MAX(((cond_a_n[i] - 1) * cond_a_n[i]) / 2, 1) * sizeof(double));
+    for (i = 0; i < nclusters_b; i++) intra_b[i] = (double*) malloc(MAX(((cond_b_n[i] - 1) * cond_b_n[i]) / 2, 1) * sizeof(double));
+    for (c = 0; c < 2; c++) {
+      char* path = c ? arguments.distances_b_f_path : arguments.distances_a_f_path;
+      FILE* distances_file = fopen(path, "r");
+      char metric_name[MAX_METRIC];
+      double prune, sparse;
+      if (!distances_file) {
+        fprintf(stderr, "%s - %s\n", ERR_CORRELATIONS_F_NOT_READABLE, path);
+        return(1);
       }
-    }
-    qsort(intra_a[i], td, sizeof(double), cmpds);
-  }
 
-  // Calculate intracluster distances for condition B
-  fprintf(stderr, "[LOG] CALCULATING INTRA CLUSTER DISTANCES FOR CONDITION B\n");
-  intra_b = (double**) malloc(nclusters_b * sizeof(double*));
-  for (i = 0; i < nclusters_b; i++) {
-    int nc = cond_b_n[i];
-    int td = ((nc - 1) * nc) / 2;
-    intra_b[i] = (double*) malloc (td * sizeof(double));
-    int idx = 0;
-    for (j = 0; j < (nc - 1); j++) {
-      profile_struct_annotation pa;
-      pa.profile = cond_b[i][j].profile;
-      int l; 
-      for (l = 0; l < MAX_PROFILE_LENGTH; l++) pa.noise[l] = cond_b[i][j].noise[l];
-      pa.length = cond_b[i][j].length;
-      for (k = j + 1; k < nc; k++) {
-        profile_struct_annotation pb;
-        pb.profile = cond_b[i][k].profile;
-        for (l = 0; l < MAX_PROFILE_LENGTH; l++) pb.noise[l] = cond_b[i][k].noise[l];
-        pb.length = cond_b[i][k].length;
-        double xcr = xdtw(&pa, &pb);
-        if (xcr < 0) xcr = 0;
-        intra_b[i][idx] = 1 - xcr;
-        idx++;
+      // Distances must have been calculated by annotate with the same metric
+      if ((read_distances_header(distances_file, metric_name, &prune, &sparse) != 1) || (strcmp(metric_name, metric->name) != 0)) {
+        fprintf(stderr, "%s - %s\n", ERR_DISTANCES_F_METRIC, path);
+        return(1);
+      }
+      result = load_intra(distances_file, c ? nprofiles_b : nprofiles_a, c ? lines_b : lines_a, dist.condition_n[c], c ? nclusters_b : nclusters_a, dist.intra[c]);
+      if (result < 0) {
+        fprintf(stderr, "%s - %s\n", (result == -2) ? ERR_DISTANCES_F_NOT_MEASURED : ERR_DISTANCES_F_NOT_MATCHING, path);
+        return(1);
       }
+      fclose(distances_file);
     }
-    qsort(intra_b[i], td, sizeof(double), cmpds);
-  }
 
-  // Calculate partners
-  for (i = 0; i < nclusters_a; i++) {
-    for (j = 0; j < nclusters_b; j++) {
-      int idxi;
-      int idxj;
-
-      for (idxi = 0; idxi < cond_a_n[i]; idxi++) {
-        profile_struct_diffproc pda = cond_a[i][idxi];
-        for (idxj = 0; idxj < cond_b_n[j]; idxj++) {
-          profile_struct_diffproc pdb = cond_b[j][idxj];
-          if ((strcmp(pda.chromosome, pdb.chromosome) == 0) && (pda.strand == pdb.strand) &&
-              (pdb.start <= pda.end) && (pda.start <= pdb.end)) {
-            cond_a[i][idxi].partner = &cond_b[j][idxj];
-            cond_b[j][idxj].partner = &cond_a[i][idxi];
-          }
-        }
+    // Sort the intracluster distances of every cluster, largest clusters first
+    for (c = 0; c < 2; c++) {
+      for (i = 0; i < (c ? nclusters_b : nclusters_a); i++) {
+        jobs[njobs].condition = c;
+        jobs[njobs].cluster = i;
+        jobs[njobs].index = 0;
+        jobs[njobs].cost = dist.condition_n[c][i];
+        njobs++;
       }
     }
+    qsort(jobs, njobs, sizeof(dpjob_struct), cmpjob);
+    parallel_for(njobs, arguments.threads, 1, sort_task, &dist);
   }
 
+  // Calculate partners
+  find_partners(cond_a, cond_a_n, nclusters_a, cond_b, cond_b_n, nclusters_b);
+
   // Open output file for differentially processed profiles 
   char *profile_output_name = malloc((MAX_PATH + strlen(DIFFPROC_PROFILE_O_SUFFIX) + 2) * sizeof(char));
   strncpy(profile_output_name, arguments.output_f_path, MAX_PATH);
@@ -328,126 +756,161 @@ int diffproc_sc(int argc, char **argv)
   fprintf(stderr, "[LOG] ASSESSING DIFFERENTIALLY PROCESSED PROFILES BETWEEN CONDITIONS\n");
   fprintf(stderr, "      pval < %f\n", arguments.pvalue);
   fprintf(stderr, "      fold-change >= %.2f\n", arguments.foldchange);
-  for (i = 0; i < nclusters_a; i++) {
-    int idxi;
-    for (idxi = 0; idxi < cond_a_n[i]; idxi++) {
-
-      // Profile has no partner
-      if (cond_a[i][idxi].partner == NULL)
-        fprintf(profiles_file, "%s:%d-%d:%s\tNA\tNA\tNA\tNA\tNA\n", cond_a[i][idxi].chromosome, cond_a[i][idxi].start, cond_a[i][idxi].end, strands[cond_a[i][idxi].strand]);
-
-      // Profile has partner
-      else {
-        int j = cond_a[i][idxi].partner->cluster - 1;
-        int idxj = cond_a[i][idxi].partner->position;
-
-        int tda = ((cond_a_n[i] - 1) * cond_a_n[i]) / 2;
-        int tdb = ((cond_b_n[j] - 1) * cond_b_n[j]) / 2;
-        int tdab = cond_b_n[j];
-        int tdba = cond_a_n[i];
-
-        profile_struct_diffproc pda = cond_a[i][idxi];
-        profile_struct_diffproc pdb = cond_b[j][idxj];
-
-        profile_struct_annotation pa;
-        pa.profile = pda.profile; 
-        for (k = 0; k < MAX_PROFILE_LENGTH; k++) pa.noise[k] = pda.noise[k];
-        pa.length = pda.length;
-
-        profile_struct_annotation pb;
-        pb.profile = pdb.profile;
-        for (k = 0; k < MAX_PROFILE_LENGTH; k++) pb.noise[k] = pdb.noise[k];
-        pb.length = pdb.length;
-
-        // Calculate distance between same profile
-        double pxcr = xdtw(&pa, &pb);
-        if (pxcr < 0) pxcr = 0;
-        pxcr = 1 - pxcr;
-
-        // Calculate profile in A against cluster in B
-        double* interab = (double*) malloc(tdab * sizeof(double));
-        int idxjj;
-        for(idxjj = 0; idxjj < tdab; idxjj++) {
-          profile_struct_annotation pbb;
-          pbb.profile = cond_b[j][idxjj].profile;
-          for (k = 0; k < MAX_PROFILE_LENGTH; k++) pbb.noise[k] = cond_b[j][idxjj].noise[k];
-          pbb.length = cond_b[j][idxjj].length;
-          double xcr = xdtw(&pa, &pbb);
-          if (xcr < 0) xcr = 0;
-          interab[idxjj] = 1 - xcr;
+
+  assessments = (assessment_struct**) malloc(MAX(nclusters_a, 1) * sizeof(assessment_struct*));
+  for (i = 0; i < nclusters_a; i++) assessments[i] = (assessment_struct*) malloc(MAX(cond_a_n[i], 1) * sizeof(assessment_struct));
+  dist.assessments = assessments;
+
+  // Clusters of condition A are assessed in batches: one cluster at a time in streaming mode, all of them otherwise.
+  // A batch loads its clusters and the clusters of condition B where their partners are. Every cluster is released
+  // after the last batch that needs it, so clusters of condition B shared by several batches are loaded only once.
+  batch = arguments.streaming ? 1 : MAX(nclusters_a, 1);
+  for (first = 0; first < nclusters_a; first += batch) {
+    last = MIN(first + batch, nclusters_a);
+    for (i = first; i < last; i++) {
+      for (j = 0; j < cond_a_n[i]; j++) {
+        if (cond_a[i][j].partner != NULL) {
+          dist.until[0][i] = last;
+          dist.until[1][cond_a[i][j].partner->cluster - 1] = last;
         }
-        qsort(interab, tdab, sizeof(double), cmpds);
-
-        // Calculate profile in B against cluster in A
-        double* interba = (double*) malloc(tdba * sizeof(double));
-        int idxii;
-        for(idxii = 0; idxii < tdba; idxii++) {
-          profile_struct_annotation paa;  
-          paa.profile = cond_a[i][idxii].profile;
-          for (k = 0; k < MAX_PROFILE_LENGTH; k++) paa.noise[k] = cond_a[i][idxii].noise[k];
-          paa.length = cond_a[i][idxii].length;
-          double xcr = xdtw(&paa, &pb);
-          if (xcr < 0) xcr = 0;
-          interba[idxii] = 1 - xcr;
+      }
+    }
+  }
+  for (first = 0; first < nclusters_a; first += batch) {
+    last = MIN(first + batch, nclusters_a);
+
+    // Clusters needed by the profiles of the batch that have a partner
+    for (i = first; i < last; i++) {
+      for (j = 0; j < cond_a_n[i]; j++) {
+        if (cond_a[i][j].partner != NULL) {
+          dist.needed[0][i] = last;
+          dist.needed[1][cond_a[i][j].partner->cluster - 1] = last;
         }
-        qsort(interba, tdba, sizeof(double), cmpds);
+      }
+    }
 
-        // Assess differential processing of profile in A against cluster in B
-        // Assess differential processing of profile in B against cluster in A
-        int adpc = assess_dp_p(intra_a[i], tda, interba, tdba, intra_b[j], tdb, interab, tdab, arguments.pvalue);
+    // Load the clusters that are not loaded yet
+    nloads = 0;
+    for (c = 0; c < 2; c++) {
+      for (i = (c ? 0 : first); i < (c ? nclusters_b : last); i++) {
+        if ((dist.needed[c][i] != last) || dist.loaded[c][i])
+          continue;
+        if (load_cluster(c ? profiles_b_file : profiles_a_file, dist.condition[c][i], dist.condition_n[c][i], metric) < 0) {
+          fprintf(stderr, "%s - %s\n", ERR_PROFILE_F_NOT_READABLE, c ? arguments.profiles_b_f_path : arguments.profiles_a_f_path);
+          return(1);
+        }
+        dist.loaded[c][i] = 1;
+        loads[nloads].condition = c;
+        loads[nloads].cluster = i;
+        loads[nloads].index = 0;
+        loads[nloads].cost = dist.condition_n[c][i];
+        nloads++;
+      }
+    }
 
-        // Assess magnitude of change
-        double mean_a = gsl_stats_median_from_sorted_data(intra_a[i], 1, tda);
-        double mean_b = gsl_stats_median_from_sorted_data(intra_b[j], 1, tdb);
-        int pdcp = ((pxcr / mean_b) >= arguments.foldchange) && ((pxcr / mean_a) >= arguments.foldchange);
+    // Calculate the intracluster distances of the loaded clusters
+    // One job per row of the pairwise distances of every cluster, largest rows first
+    if (!arguments.distances) {
+      njobs = 0;
+      for (j = 0; j < nloads; j++) {
+        int nc = dist.condition_n[loads[j].condition][loads[j].cluster];
+        dist.intra[loads[j].condition][loads[j].cluster] = (double*) malloc(MAX(((nc - 1) * nc) / 2, 1) * sizeof(double));
+        for (i = 0; i < (nc - 1); i++) {
+          jobs[njobs].condition = loads[j].condition;
+          jobs[njobs].cluster = loads[j].cluster;
+          jobs[njobs].index = i;
+          jobs[njobs].cost = nc - 1 - i;
+          njobs++;
+        }
+      }
+      qsort(jobs, njobs, sizeof(dpjob_struct), cmpjob);
+      parallel_for(njobs, arguments.threads, 1, intra_task, &dist);
 
-        // Print results
-        fprintf(profiles_file, "%s:%d-%d:%s\t", pda.chromosome, pda.start, pda.end, strands[pda.strand]);
-        fprintf(profiles_file, "%s:%d-%d:%s\t", pdb.chromosome, pdb.start, pdb.end, strands[pdb.strand]);
+      // Sort them, largest clusters first
+      qsort(loads, nloads, sizeof(dpjob_struct), cmpjob);
+      memcpy(jobs, loads, nloads * sizeof(dpjob_struct));
+      parallel_for(nloads, arguments.threads, 1, sort_task, &dist);
+    }
 
-        if (adpc < 0)
+    // One job per profile in condition A with a partner, largest comparisons first
+    njobs = 0;
+    for (i = first; i < last; i++) {
+      for (j = 0; j < cond_a_n[i]; j++) {
+        if (cond_a[i][j].partner != NULL) {
+          jobs[njobs].condition = 0;
+          jobs[njobs].cluster = i;
+          jobs[njobs].index = j;
+          jobs[njobs].cost = (long) cond_a_n[i] + cond_b_n[cond_a[i][j].partner->cluster - 1];
+          njobs++;
+        }
+      }
+    }
+    qsort(jobs, njobs, sizeof(dpjob_struct), cmpjob);
+    parallel_for(njobs, arguments.threads, 1, assess_task, &dist);
+
+    // Print results of the batch in the order of the profiles
+    for (i = first; i < last; i++) {
+      int idxi;
+      for (idxi = 0; idxi < cond_a_n[i]; idxi++) {
+        profile_struct_diffproc* pda = &cond_a[i][idxi];
+        assessment_struct result = assessments[i][idxi];
+
+        // Profile has no partner
+        if (pda->partner == NULL) {
+          fprintf(profiles_file, "%s:%d-%d:%s\tNA\tNA\tNA\tNA\tNA\n", pda->chromosome, pda->start, pda->end, strands[pda->strand]);
+          continue;
+        }
+
+        // Profile has partner
+        profile_struct_diffproc* pdb = pda->partner;
+        fprintf(profiles_file, "%s:%d-%d:%s\t", pda->chromosome, pda->start, pda->end, strands[pda->strand]);
+        fprintf(profiles_file, "%s:%d-%d:%s\t", pdb->chromosome, pdb->start, pdb->end, strands[pdb->strand]);
+
+        if (result.adpc < 0)
           fprintf(profiles_file, "NA\t");
-        else if (adpc == 0)
+        else if (result.adpc == 0)
           fprintf(profiles_file, "NO\t");
         else
           fprintf(profiles_file, "YES\t");
-        
-        if (pdcp == 0)
+
+        if (result.pdcp == 0)
           fprintf(profiles_file, "NO\t");
         else
           fprintf(profiles_file, "YES\t");
 
-        fprintf(profiles_file, "%.2f\t%.2f\t%d\t%d\n", pxcr / mean_b, pxcr / mean_a, tda, tdb);
-
-        free(interab);
-        free(interba);        
+        fprintf(profiles_file, "%.2f\t%.2f\t%d\t%d\n", result.fold_b, result.fold_a, result.tda, result.tdb);
       }
     }
+
+    // Release the clusters that no later batch needs
+    for (c = 0; c < 2; c++)
+      for (i = 0; i < (c ? nclusters_b : nclusters_a); i++)
+        if (dist.loaded[c][i] && (dist.until[c][i] == last))
+          unload_cluster(&dist, c, i);
   }
 
   // Print each profile in condition B that does not have a partner
   for (i = 0; i < nclusters_b; i++) {
     int idxi;
     for (idxi = 0; idxi < cond_b_n[i]; idxi++) {
-      profile_struct_diffproc pda = cond_b[i][idxi];
-      if (pda.partner == NULL)
-        fprintf(profiles_file, "NA\t%s:%d-%d:%s\tNA\tNA\tNA\tNA\n", pda.chromosome, pda.start, pda.end, strands[pda.strand]);
+      profile_struct_diffproc* pdb = &cond_b[i][idxi];
+      if (pdb->partner == NULL)
+        fprintf(profiles_file, "NA\t%s:%d-%d:%s\tNA\tNA\tNA\tNA\n", pdb->chromosome, pdb->start, pdb->end, strands[pdb->strand]);
     }
   }
 
   // Close descriptors
   fclose(profiles_file);
+  fclose(profiles_a_file);
+  fclose(profiles_b_file);
 
   // Free pointer and exit
   for (i = 0; i < nclusters_a; i++) {
-    for (j = 0; j < cond_a_n[i]; j++)
-      free(cond_a[i][j].profile);
     free(cond_a[i]);
     free(intra_a[i]);
+    free(assessments[i]);
   }
   for (i = 0; i < nclusters_b; i++) {
-    for (j = 0; j < cond_b_n[i]; j++)
-      free(cond_b[i][j].profile);
     free(cond_b[i]);
     free(intra_b[i]);
   }
@@ -457,5 +920,16 @@ int diffproc_sc(int argc, char **argv)
   free(cond_b_n);
   free(intra_a);
   free(intra_b);
+  free(dist.loaded[0]);
+  free(dist.loaded[1]);
+  free(dist.needed[0]);
+  free(dist.needed[1]);
+  free(dist.until[0]);
+  free(dist.until[1]);
+  free(assessments);
+  free(jobs);
+  free(loads);
+  free(lines_a);
+  free(lines_b);
   return(0);
 }
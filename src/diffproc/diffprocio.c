@@ -120,18 +120,55 @@ int next_diffproc_feature(FILE* bedf, feature_struct_diffproc* feature)
 }
 
 /*
- * next_diffproc_profile
+ * diffproc_location
+ *   Parses the location <chromosome:start-end:strand> of a profile line
+ *
+ * @return
+ *   0 if success. -1 if the location is ill-formatted.
+ */
+int diffproc_location(char* token, profile_struct_diffproc* profile)
+{
+  char* feature;
+
+  if ((feature = strtok(token, ":")) == NULL)
+    return(-1);
+  strncpy(profile->chromosome, feature, MAX_FEATURE);
+
+  if ((feature = strtok(NULL, "-")) == NULL)
+    return(-1);
+  profile->start = atoi(feature);
+
+  if ((feature = strtok(NULL, ":")) == NULL)
+    return(-1);
+  profile->end = atoi(feature);
+  profile->length = profile->end - profile->start + 1;
+
+  if ((feature = strtok(NULL, ":\t\n")) == NULL)
+    return(-1);
+
+  if (strcmp(feature, "+") == 0)
+    profile->strand = FWD_STRAND;
+  else if (strcmp(feature, "-") == 0)
+    profile->strand = REV_STRAND;
+  else
+    return(-1);
+
+  return(0);
+}
+
+/*
+ * next_diffproc_location
  *
  * @see include/diffproc/diffprocio.h
  */
-int next_diffproc_profile(FILE* fp, profile_struct_diffproc* profile)
+int next_diffproc_location(FILE* fp, profile_struct_diffproc* profile)
 {
   char *line = NULL;
-  char *token, *feature, *cline;
+  char *token;
   size_t len = 0;
   ssize_t read;
-  int i;
 
+  profile->offset = ftell(fp);
   read = getline(&line, &len, fp);
 
   if (read < 0) {
@@ -139,48 +176,55 @@ int next_diffproc_profile(FILE* fp, profile_struct_diffproc* profile)
     return(0);
   }
 
-  cline = (char*) malloc((strlen(line) + 1) * sizeof(char));
-  strcpy(cline, line);
-
-  if ((token = strtok(line, "\t")) == NULL) {
-    free(cline);
+  if (((token = strtok(line, "\t")) == NULL) || (diffproc_location(token, profile) < 0)) {
     free(line);
     return(-1);
   }
 
-  if ((feature = strtok(token, ":")) == NULL)  {
-    free(cline);
-    free(line);
-    return(-1);
-  }
-  strcpy(profile->chromosome, feature);
+  strncpy(profile->annotation, "unknown", MAX_FEATURE);
+  profile->profile = NULL;
+  profile->noise = NULL;
+  profile->features = NULL;
+  profile->cluster = -1;
+  profile->position = -1;
+  profile->differential = 0;
+  profile->partner = NULL;
 
-  if ((feature = strtok(NULL, "-")) == NULL)  {
-    free(cline);
-    free(line);
-    return(-1);
-  }
-  profile->start = atoi(feature);
+  free(line);
+  return(1);
+}
 
-  if ((feature = strtok(NULL, ":")) == NULL)  {
-    free(cline);
+/*
+ * next_diffproc_profile
+ *
+ * @see include/diffproc/diffprocio.h
+ */
+int next_diffproc_profile(FILE* fp, profile_struct_diffproc* profile)
+{
+  char *line = NULL;
+  char *token, *cline;
+  size_t len = 0;
+  ssize_t read;
+  int i;
+
+  profile->offset = ftell(fp);
+  read = getline(&line, &len, fp);
+
+  if (read < 0) {
     free(line);
-    return(-1);
+    return(0);
   }
-  profile->end = atoi(feature);
-  profile->length = profile->end - profile->start + 1;
 
-  if ((feature = strtok(NULL, ":")) == NULL)  {
+  cline = (char*) malloc((strlen(line) + 1) * sizeof(char));
+  strcpy(cline, line);
+
+  if ((token = strtok(line, "\t")) == NULL) {
     free(cline);
     free(line);
     return(-1);
   }
 
-  if (strcmp(feature, "+") == 0)
-    profile->strand = FWD_STRAND;
-  else if (strcmp(feature, "-") == 0)
-    profile->strand = REV_STRAND;
-  else {
+  if (diffproc_location(token, profile) < 0) {
     free(cline);
     free(line);
     return(-1);
@@ -205,7 +249,9 @@ int next_diffproc_profile(FILE* fp, profile_struct_diffproc* profile)
   }
 
   strncpy(profile->annotation, "unknown", MAX_FEATURE);
+  profile->noise = (double*) malloc(MAX_PROFILE_LENGTH * sizeof(double));
   pgnoise(profile->profile, gsl_stats_mean(profile->profile, 1, profile->length), gsl_stats_variance(profile->profile, 1, profile->length), profile->noise, MAX_PROFILE_LENGTH);
+  profile->features = NULL;
   profile->cluster = -1;
   profile->position = -1;
   profile->differential = 0;
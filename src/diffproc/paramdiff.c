@@ -11,7 +11,7 @@ int parse_command_line_d(int argc, char** argv, char** error_message, args_d_str
   char carg;
   int terminate = 0;
 
-  while(((carg = getopt(argc, argv, "hvg:")) != -1) && (terminate >= 0)) {
+  while(((carg = getopt(argc, argv, "hvsg:d:j:x:")) != -1) && (terminate >= 0)) {
     switch (carg) {
       case 'h':
         terminate--;
@@ -21,9 +21,21 @@ int parse_command_line_d(int argc, char** argv, char** error_message, args_d_str
         terminate--;
         *error_message = VERSION_MSG;
         break;
+      case 's':
+        arguments->streaming = 1;
+        break;
       case 'g':
         terminate = parse_filter_output_parameters(optarg, error_message, arguments);
         break;
+      case 'd':
+        terminate = parse_metric_parameters_d(optarg, error_message, arguments);
+        break;
+      case 'j':
+        terminate = parse_threads_parameters_d(optarg, error_message, arguments);
+        break;
+      case 'x':
+        terminate = parse_distances_parameters(optarg, error_message, arguments);
+        break;
       case '?':
         terminate--;
         *error_message = ERR_INVALID_ARGUMENT;
@@ -90,3 +102,70 @@ int parse_filter_output_parameters(char* option, char** error_message, args_d_st
 
   return(0);
 }
+
+
+/*
+ * parse_metric_parameters_d
+ *
+ * @see include/diffproc/paramdiff.h
+ */
+int parse_metric_parameters_d(char* option, char** error_message, args_d_struct* arguments)
+{
+  arguments->metric = metric_find(option);
+  if (arguments->metric < 0) {
+    *error_message = ERR_INVALID_d_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_threads_parameters_d
+ *
+ * @see include/diffproc/paramdiff.h
+ */
+int parse_threads_parameters_d(char* option, char** error_message, args_d_struct* arguments)
+{
+  arguments->threads = atoi(option);
+  if (arguments->threads < 1) {
+    *error_message = ERR_INVALID_j_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_distances_parameters
+ *
+ * @see include/diffproc/paramdiff.h
+ */
+int parse_distances_parameters(char* option, char** error_message, args_d_struct* arguments)
+{
+  char* token;
+
+  if (strchr(option, ':') == NULL) {
+    *error_message = ERR_INVALID_x_VALUE;
+    return(-1);
+  }
+
+  if ((token = strtok(option, ":")) != NULL)
+    strncpy(arguments->distances_a_f_path, token, MAX_PATH);
+  else {
+    *error_message = ERR_INVALID_x_VALUE;
+    return(-1);
+  }
+
+  if ((token = strtok(NULL, ":")) != NULL)
+    strncpy(arguments->distances_b_f_path, token, MAX_PATH);
+  else {
+    *error_message = ERR_INVALID_x_VALUE;
+    return(-1);
+  }
+  arguments->distances = 1;
+
+  return(0);
+}
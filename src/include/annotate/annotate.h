@@ -1,10 +1,44 @@
 #include <annotate/xcorr.h>
 #include <annotate/iofile.h>
+#include <annotate/bedload.h>
 #include <annotate/hierarchical.h>
 #include <annotate/paramclust.h>
 #include <annotate/profilemap.h>
+#include <annotate/sweep.h>
 #include <annotate/dtw.h>
+#include <annotate/metric.h>
+#include <annotate/prune.h>
 #include <annotate/annotation.h>
 #include <annotate/dclust.h>
 
+/*
+ * Application entry point
+ */
 int annotate_sc(int argc, char** argv);
+
+/*
+ * annotate_defaults
+ *   Sets the default values of the annotate options
+ *
+ * @arg args_a_struct* arguments
+ *   Pointer to the argument handler
+ */
+void annotate_defaults(args_a_struct* arguments);
+
+/*
+ * annotate_profiles
+ *   Annotates, computes the distances and clusters profiles loaded in memory, and writes the results to the
+ *   output folder. Annotations, scores and clusters of the profiles are overwritten.
+ *   Errors are reported to the standard error.
+ *
+ * @arg args_a_struct* arguments
+ *   Pointer to the argument handler
+ * @arg profile_struct_annotation* profiles
+ *   An array of profiles, as loaded by next_profile
+ * @arg int nprofiles
+ *   Total number of profiles
+ *
+ * @return
+ *   0 if success. 1 otherwise.
+ */
+int annotate_profiles(args_a_struct* arguments, profile_struct_annotation* profiles, int nprofiles);
@@ -1,5 +1,5 @@
 #include <core/structs.h>
-#include <annotate/strmap.h>
+#include <core/chrdict.h>
 
 /*
  * xcorr_annotate
@@ -18,7 +18,9 @@ void xcorr_annotate(annotation_struct** xcorr, int nprofiles, profile_struct_ann
 /*
  * cluster_annotate
  *
- * Annotation of profiles based on majority vote within clusters
+ * Annotation of profiles based on majority vote within clusters.
+ * Classes are interned to integer identifiers and clusters are gathered with a counting sort,
+ * so it takes linear time and memory.
  *
  * @arg int nclusters
  *   Total number of clusters
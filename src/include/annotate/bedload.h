@@ -0,0 +1,54 @@
+#include <limits.h>
+#include <core/parallel.h>
+#include <annotate/iofile.h>
+
+/*
+ * load_features
+ *   Reads the features of all the annotation files in parallel.
+ *   Files are split into chunks of BED_CHUNK_SIZE bytes at line boundaries and every chunk is parsed by a task.
+ *   Chunks are merged in the order of the files and of the lines within them, so the features are
+ *   the same and in the same order as if the files were read sequentially, regardless of the number of threads.
+ *   Empty lines are skipped.
+ *
+ * @arg args_a_struct* arguments
+ *   Pointer to a struct handling the command line parameters
+ * @arg feature_struct** features
+ *   Pointer to the array where the features are stored. It is allocated by the function.
+ * @arg int* failed
+ *   Pointer to an int where the index of the first annotation file that is not readable
+ *   or is ill-formatted is stored
+ *
+ * @return
+ *   The number of features. -1 if an annotation file is not readable or is ill-formatted.
+ *   -2 if there is not enough memory.
+ */
+long load_features(args_a_struct* arguments, feature_struct** features, int* failed);
+
+/*
+ * Function that consumes a batch of features read by stream_features
+ */
+typedef void (*bedload_batch)(args_a_struct* arguments, feature_struct* features, long nfeatures, void* data);
+
+/*
+ * stream_features
+ *   Reads the features of all the annotation files as load_features, but only keeps the chunks of a window
+ *   of one chunk per thread in memory. Once a window is parsed, the features of its chunks are handed over
+ *   to a batch function in the order of the files and of the lines within them, and freed.
+ *   Memory is bounded by the number of threads times BED_CHUNK_SIZE, except for the files that can not be sized,
+ *   such as pipes, which are read whole.
+ *
+ * @arg args_a_struct* arguments
+ *   Pointer to a struct handling the command line parameters
+ * @arg bedload_batch batch
+ *   Function called with every batch of features
+ * @arg void* data
+ *   Data passed to the batch function
+ * @arg int* failed
+ *   Pointer to an int where the index of the first annotation file that is not readable
+ *   or is ill-formatted is stored
+ *
+ * @return
+ *   The number of features. -1 if an annotation file is not readable or is ill-formatted.
+ *   -2 if there is not enough memory. Batches before the failure have already been handed over.
+ */
+long stream_features(args_a_struct* arguments, bedload_batch batch, void* data, int* failed);
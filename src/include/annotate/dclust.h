@@ -1,4 +1,10 @@
 #include <core/structs.h>
+#include <core/parallel.h>
+#include <core/quantile.h>
+#include <annotate/graph.h>
+#include <annotate/nnlist.h>
+#include <annotate/density.h>
+#include <annotate/distribution.h>
 #include <float.h>
 
 /*
@@ -20,15 +26,41 @@
  *   Number of elements in dist
  * @arg double* max
  *   Pointer to a double variable where the maximum distance in dist will be stored
+ * @arg double tolerance
+ *   Increment of sigma of the grid where dc is searched
+ * @arg int nthreads
+ *   Number of worker threads
  *
  * @return
  *   Optimal distance cutoff (dc) for the dclust clustering algorithm
  */
-double dcoptimize(double** dist, int n, double* max);
+double dcoptimize(double** dist, int n, double* max, double tolerance, int nthreads);
+
+/*
+ * Optimization of the distance cutoff (dc) on a sparse distance graph.
+ * Pairs that are not stored in the graph are at the sentinel distance.
+ *
+ * @arg graph_struct* graph
+ *   Finalized sparse distance graph
+ * @arg double* max
+ *   Pointer to a double variable where the maximum distance will be stored
+ * @arg double tolerance
+ *   Increment of sigma of the grid where dc is searched
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   Optimal distance cutoff (dc) for the dclust clustering algorithm
+ */
+double dcoptimize_graph(graph_struct* graph, double* max, double tolerance, int nthreads);
 
 /*
  * Calculate a clustering by fast search and find of density peaks
  *
+ * Distances are only read once per point to calculate densities. Neighbour lists
+ * sorted by distance and truncated at a multiple of dc are then used to find the
+ * nearest neighbour of higher density and the border densities of clusters.
+ *
  * @reference: Rodriguez A. and Laio A. "Clustering by fast search and find of density peaks".
  *             Science 27 June 2014.
  *
@@ -42,16 +74,52 @@ double dcoptimize(double** dist, int n, double* max);
  *   Distance cutoff (dc). -1 for automatic calculation.
  * @arg int gaussian
  *   0 if no gaussian kernel for density calculation. 1 otherwise.
+ * @arg double tolerance
+ *   Increment of sigma of the grid where dc is searched
+ * @arg double truncation
+ *   Gaussian density contributions of points at a distance >= truncation * dc are ignored.
+ *   0 to add all the contributions.
+ * @arg int nthreads
+ *   Number of worker threads
  *
  * @return
- *   Number of clusters
+ *   Number of clusters. -1 if there is not enough memory for the neighbour lists.
+ */
+int dclust(double** dist, int n, profile_struct_annotation* profiles, double cutoff, int gaussian, double tolerance, double truncation, int nthreads);
+
+/*
+ * Calculate a clustering by fast search and find of density peaks on a sparse distance graph.
+ * Pairs that are not stored in the graph are at the sentinel distance.
+ *
+ * @arg graph_struct* graph
+ *   Finalized sparse distance graph
+ * @arg profile_struct_annotation* profiles
+ *   An array of profiles
+ * @arg double cutoff
+ *   Distance cutoff (dc). -1 for automatic calculation.
+ * @arg int gaussian
+ *   0 if no gaussian kernel for density calculation. 1 otherwise.
+ * @arg double tolerance
+ *   Increment of sigma of the grid where dc is searched
+ * @arg double truncation
+ *   Gaussian density contributions of points at a distance >= truncation * dc are ignored.
+ *   0 to add all the contributions.
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   Number of clusters. -1 if there is not enough memory for the neighbour lists.
  */
-int dclust(double** dist, int n, profile_struct_annotation* profiles, double cutoff, int gaussian);
+int dclust_graph(graph_struct* graph, profile_struct_annotation* profiles, double cutoff, int gaussian, double tolerance, double truncation, int nthreads);
 
 /*
  * Calculate a clustering by fast search and find of density peaks
  * Iterative variation
  *
+ * The points that are not clustered yet are handled as an index view over dist.
+ * Pairwise distances are sorted only once and their distribution is updated as
+ * points are clustered.
+ *
  * @arg double** dist
  *   Distance/dissimilarity matrix
  * @arg int n
@@ -62,8 +130,40 @@ int dclust(double** dist, int n, profile_struct_annotation* profiles, double cut
  *   Distance cutoff to stop iterations
  * @arg int gaussian
  *   0 if no gaussian kernel for density calculation. 1 otherwise.
+ * @arg double tolerance
+ *   Increment of sigma of the grid where dc is searched
+ * @arg double truncation
+ *   Gaussian density contributions of points at a distance >= truncation * dc are ignored.
+ *   0 to add all the contributions.
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   Number of clusters
+ */
+int dclustr(double** dist, int n, profile_struct_annotation* profiles, double cf, int gaussian, double tolerance, double truncation, int nthreads);
+
+/*
+ * Calculate a clustering by fast search and find of density peaks on a sparse distance graph.
+ * Iterative variation. Pairs that are not stored in the graph are at the sentinel distance.
+ *
+ * @arg graph_struct* graph
+ *   Finalized sparse distance graph
+ * @arg profile_struct_annotation* profiles
+ *   An array of profiles
+ * @arg double cf
+ *   Distance cutoff to stop iterations
+ * @arg int gaussian
+ *   0 if no gaussian kernel for density calculation. 1 otherwise.
+ * @arg double tolerance
+ *   Increment of sigma of the grid where dc is searched
+ * @arg double truncation
+ *   Gaussian density contributions of points at a distance >= truncation * dc are ignored.
+ *   0 to add all the contributions.
+ * @arg int nthreads
+ *   Number of worker threads
  *
  * @return
  *   Number of clusters
  */
-int dclustr(double** dist, int n, profile_struct_annotation* profiles, double cf, int gaussian);
+int dclustr_graph(graph_struct* graph, profile_struct_annotation* profiles, double cf, int gaussian, double tolerance, double truncation, int nthreads);
@@ -0,0 +1,132 @@
+#include <core/structs.h>
+#include <core/parallel.h>
+#include <float.h>
+#include <annotate/graph.h>
+
+/*
+ * kernel_density
+ *   Calculates the density (RHO) of every point in a set of points
+ *     gaussian : RHO[i] = sum {exp(-(dist(i,j)/dc)^2)}, j != i
+ *     cutoff   : RHO[i] = number of points j != i that satisfy dist(i,j) < dc
+ *   Terms are added in ascending order of j, so results do not depend on the number
+ *   of threads. Distances are gathered in blocks of DENSITY_BLOCK contiguous values
+ *   so the kernel is evaluated in tight loops the compiler can vectorize.
+ *
+ * @arg double** dist
+ *   Distance/dissimilarity matrix
+ * @arg int* index
+ *   Indexes in dist of the points in the set, in ascending order. NULL for all the points.
+ * @arg int n
+ *   Number of points in the set
+ * @arg double dc
+ *   Distance cutoff, bandwidth of the gaussian kernel
+ * @arg int gaussian
+ *   0 if no gaussian kernel for density calculation. 1 otherwise.
+ * @arg double truncation
+ *   Gaussian contributions of points at a distance >= truncation * dc are ignored.
+ *   0 to add all the contributions.
+ * @arg double* rho
+ *   Array of n elements where the densities will be stored
+ * @arg int nthreads
+ *   Number of worker threads
+ */
+void kernel_density(double** dist, int* index, int n, double dc, int gaussian, double truncation, double* rho, int nthreads);
+
+/*
+ * kernel_density_graph
+ *   Same as kernel_density for a sparse distance graph. Active points that are not stored
+ *   as neighbours of a point contribute as points at the sentinel distance.
+ *
+ * @arg graph_struct* graph
+ *   Finalized sparse distance graph
+ * @arg int* index
+ *   Points of the graph in the set, in ascending order. NULL for all the points.
+ * @arg int* position
+ *   Position in index of every point of the graph, -1 if it is not in the set.
+ *   NULL for all the points.
+ * @arg int n
+ *   Number of points in the set
+ * @arg double dc
+ *   Distance cutoff, bandwidth of the gaussian kernel
+ * @arg int gaussian
+ *   0 if no gaussian kernel for density calculation. 1 otherwise.
+ * @arg double truncation
+ *   Gaussian contributions of points at a distance >= truncation * dc are ignored.
+ *   0 to add all the contributions.
+ * @arg double* rho
+ *   Array of n elements where the densities will be stored
+ * @arg int nthreads
+ *   Number of worker threads
+ */
+void kernel_density_graph(graph_struct* graph, int* index, int* position, int n, double dc, int gaussian, double truncation, double* rho, int nthreads);
+
+/*
+ * density_histogram
+ *   Bins the distances from every point in a set to the rest of the points of the set,
+ *   so gaussian densities can be approximated for many bandwidths with kernel_density_binned.
+ *   Distances beyond the last bin are ignored.
+ *
+ * @arg double** dist
+ *   Distance/dissimilarity matrix
+ * @arg int* index
+ *   Indexes in dist of the points in the set, in ascending order. NULL for all the points.
+ * @arg int n
+ *   Number of points in the set
+ * @arg double width
+ *   Width of the bins
+ * @arg int nbins
+ *   Number of bins per point
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   A newly allocated array of n * nbins counts, one row of nbins per point
+ */
+int* density_histogram(double** dist, int* index, int n, double width, int nbins, int nthreads);
+
+/*
+ * density_histogram_graph
+ *   Same as density_histogram for a sparse distance graph
+ *
+ * @arg graph_struct* graph
+ *   Finalized sparse distance graph
+ * @arg int* index
+ *   Points of the graph in the set, in ascending order. NULL for all the points.
+ * @arg int* position
+ *   Position in index of every point of the graph, -1 if it is not in the set.
+ *   NULL for all the points.
+ * @arg int n
+ *   Number of points in the set
+ * @arg double width
+ *   Width of the bins
+ * @arg int nbins
+ *   Number of bins per point
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   A newly allocated array of n * nbins counts, one row of nbins per point
+ */
+int* density_histogram_graph(graph_struct* graph, int* index, int* position, int n, double width, int nbins, int nthreads);
+
+/*
+ * kernel_density_binned
+ *   Approximates the gaussian density of every point from its binned distances,
+ *   evaluating the kernel once per bin centre
+ *
+ * @arg int* histogram
+ *   Histogram returned by density_histogram
+ * @arg int n
+ *   Number of points
+ * @arg double width
+ *   Width of the bins
+ * @arg int nbins
+ *   Number of bins per point
+ * @arg double dc
+ *   Bandwidth of the gaussian kernel
+ * @arg double* rho
+ *   Array of n elements where the densities will be stored
+ * @arg int nthreads
+ *   Number of worker threads
+ */
+void kernel_density_binned(int* histogram, int n, double width, int nbins, double dc, double* rho, int nthreads);
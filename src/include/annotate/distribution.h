@@ -0,0 +1,105 @@
+#include <core/structs.h>
+#include <annotate/graph.h>
+
+/*
+ * distribution_create
+ *   Sorts all the pairwise distances in a distance matrix once and builds an index
+ *   over them, so that order statistics of the distances between the points that
+ *   remain active can be queried while points are being removed.
+ *
+ * @arg double** dist
+ *   Distance/dissimilarity matrix
+ * @arg int n
+ *   Number of elements in dist
+ *
+ * @return
+ *   A pointer to a newly allocated distribution_struct. NULL if not enough memory.
+ */
+distribution_struct* distribution_create(double** dist, int n);
+
+/*
+ * distribution_create_graph
+ *   Same as distribution_create for a sparse distance graph. Only the stored distances
+ *   are sorted. Active pairs that are not stored count as pairs at the sentinel distance.
+ *
+ * @arg graph_struct* g
+ *   Finalized sparse distance graph. Must outlive the distribution.
+ *
+ * @return
+ *   A pointer to a newly allocated distribution_struct. NULL if not enough memory.
+ */
+distribution_struct* distribution_create_graph(graph_struct* g);
+
+/*
+ * distribution_remove
+ *   Removes from the distribution all the distances between a point and the active points.
+ *   The point is marked as not active.
+ *
+ * @arg distribution_struct* d
+ *   Pointer to the distribution
+ * @arg int point
+ *   Index of the point to be removed
+ */
+void distribution_remove(distribution_struct* d, int point);
+
+/*
+ * distribution_get
+ *   Order statistic of the distances between active points
+ *
+ * @arg distribution_struct* d
+ *   Pointer to the distribution
+ * @arg long k
+ *   0-based rank of the distance. Ranks of pairs that are not stored give the sentinel.
+ *
+ * @return
+ *   The k-th smallest distance between active points
+ */
+double distribution_get(distribution_struct* d, long k);
+
+/*
+ * distribution_quantile
+ *   Quantile of the distances between active points, interpolated as in
+ *   gsl_stats_quantile_from_sorted_data
+ *
+ * @arg distribution_struct* d
+ *   Pointer to the distribution
+ * @arg double f
+ *   Quantile, between 0 and 1
+ *
+ * @return
+ *   The quantile f of the distribution
+ */
+double distribution_quantile(distribution_struct* d, double f);
+
+/*
+ * distribution_min_nonzero
+ *   Minimum distance > 0 between active points
+ *
+ * @arg distribution_struct* d
+ *   Pointer to the distribution
+ *
+ * @return
+ *   The minimum distance > 0. 0 if all the distances are 0.
+ */
+double distribution_min_nonzero(distribution_struct* d);
+
+/*
+ * distribution_max
+ *   Maximum distance between active points
+ *
+ * @arg distribution_struct* d
+ *   Pointer to the distribution
+ *
+ * @return
+ *   The maximum distance. 0 if there are less than 2 active points.
+ */
+double distribution_max(distribution_struct* d);
+
+/*
+ * distribution_destroy
+ *   Frees a distribution struct
+ *
+ * @arg distribution_struct* d
+ *   Pointer to the distribution
+ */
+void distribution_destroy(distribution_struct* d);
@@ -43,6 +43,25 @@ double dtw(double* s, int n, double* q, int m);
  */
 double xdtw(profile_struct_annotation* p1, profile_struct_annotation* p2);
 
+/*
+ * xdtw_bounded
+ *   Same as xdtw, but the alignment is abandoned as soon as the correlation that can
+ *   still be reached from every cell of the current row is lower than a given bound.
+ *   The result is the same as xdtw whenever the correlation is >= bound.
+ *
+ * @arg profile_struct_annotation* p1
+ *   Profile handler struct containing the first time series
+ * @arg profile_struct_annotation* p2
+ *   Profile handler struct containing the second time series
+ * @arg double bound
+ *   Minimum correlation of interest. -INFINITY to never abandon.
+ *
+ * @return
+ *   Optimal normalized X-Correlation between signals in p1 and p2.
+ *   XDTW_ABANDONED if it is known to be lower than bound.
+ */
+double xdtw_bounded(profile_struct_annotation* p1, profile_struct_annotation* p2, double bound);
+
 /*
  * adtw
  *   Normalized alignment for Standard Dynamic Time Warping algorithm.
@@ -0,0 +1,57 @@
+#include <core/structs.h>
+
+/*
+ * graph_create
+ *   Creates an empty sparse distance graph
+ *
+ * @arg int n
+ *   Number of points
+ * @arg double radius
+ *   Maximum distance stored in the graph
+ * @arg double sentinel
+ *   Distance between pairs of points that are not stored. Must be >= radius.
+ *
+ * @return
+ *   A pointer to a newly allocated graph_struct. NULL if not enough memory.
+ */
+graph_struct* graph_create(int n, double radius, double sentinel);
+
+/*
+ * graph_add
+ *   Adds the distance between points i and j to the graph if it is <= radius.
+ *   Pairs must be added with i < j and in ascending order of i and then j.
+ *
+ * @arg graph_struct* g
+ *   Pointer to the graph
+ * @arg int i
+ *   Index of the first point
+ * @arg int j
+ *   Index of the second point
+ * @arg double distance
+ *   Distance between points i and j
+ *
+ * @return
+ *   1 if the pair is stored. 0 if not. -1 if not enough memory.
+ */
+int graph_add(graph_struct* g, int i, int j, double distance);
+
+/*
+ * graph_finalize
+ *   Builds the CSR layout of the graph once all the pairs have been added
+ *
+ * @arg graph_struct* g
+ *   Pointer to the graph
+ *
+ * @return
+ *   0 if success. -1 if not enough memory.
+ */
+int graph_finalize(graph_struct* g);
+
+/*
+ * graph_destroy
+ *   Frees a graph struct
+ *
+ * @arg graph_struct* g
+ *   Pointer to the graph
+ */
+void graph_destroy(graph_struct* g);
@@ -1,28 +1,50 @@
 #include <core/structs.h>
-#include <annotate/cluster.h>
+#include <core/parallel.h>
+#include <core/chrdict.h>
+
+/*
+ * hc_condense_matrix
+ *   Condensed copy of the upper triangle of a distance matrix, as used by hc_cluster
+ *
+ * @arg double** correlation
+ *   Distance matrix between profiles
+ * @arg int nprofiles
+ *   Total number of profiles
+ *
+ * @return
+ *   A newly allocated array with the n(n-1)/2 distances between i and j > i, row by row.
+ *   NULL if there is not enough memory.
+ */
+double* hc_condense_matrix(double** correlation, int nprofiles);
 
 /*
  * hc_cluster
- *   Performs pairwise maximum- (or complete)- linkage clustering
+ *   Performs pairwise maximum- (or complete)- linkage clustering with the nearest-neighbour chain algorithm,
+ *   in O(n^2) time and in place on a condensed distance matrix. Nearest-neighbour searches and distance
+ *   updates over large sets of clusters are split between threads. The result does not depend on the number of threads.
  *
  * @reference
- *    De Hoon et al. "Open Source Clustering Software". Bioinformatics(2004).
+ *    Murtagh. "A survey of recent advances in hierarchical clustering algorithms". The Computer Journal (1983).
+ *    Mullner. "Modern hierarchical, agglomerative clustering algorithms". arXiv:1109.2378 (2011).
  *
- * @arg double** correlation
- *   Correlation matrix containing distances between profiles
+ * @arg double* dist
+ *   Condensed distance matrix between profiles, as returned by hc_condense_matrix. It is overwritten.
  * @arg int nprofiles
  *   Total number of profiles
+ * @arg int threads
+ *   Number of threads
  *
  * @return
- *   A pointer to a newly allocated array of hcnode_struct structures that describes
- *   the calculated hierarchical clustering solution. NULL if hc_cluster fails due to
- *   memory allocation error
+ *   A pointer to a newly allocated array of nprofiles - 1 hcnode_struct structures, sorted by distance, that
+ *   describes the calculated hierarchical clustering solution in the layout of the C Clustering Library.
+ *   NULL if hc_cluster fails due to memory allocation error
  */
-hcnode_struct* hc_cluster(double** correlation, int nprofiles);
+hcnode_struct* hc_cluster(double* dist, int nprofiles, int threads);
 
 /*
  * hc_print
- *   Prints a hierarchical clustering solution to a file in neWick format
+ *   Prints a hierarchical clustering solution to a file in neWick format.
+ *   The tree is traversed with an explicit stack and written through a buffer of NEWICK_BUFFER bytes.
  *
  * @arg FILE* fp
  *   The file descriptor where the hierarchical clustering solution will be printed
@@ -38,7 +60,9 @@ void hc_print(FILE* fp, hcnode_struct* hc, int nprofiles, profile_struct_annotat
 /*
  * hc_branch
  *   Branches the tree given a cutoff value. All the leafs under a branch belong to the parent node
- *   that has the greatest distance that is lower or equal to the cutoff value
+ *   that has the greatest distance that is lower or equal to the cutoff value.
+ *   Branches are found in linear time with a union-find over the profiles.
+ *   Previous clusters of the profiles are overwritten.
  *
  * @arg hcnode_struct* hc
  *   A pointer to the hierarchical clustering solution
@@ -55,20 +79,23 @@ void hc_print(FILE* fp, hcnode_struct* hc, int nprofiles, profile_struct_annotat
 int hc_branch(hcnode_struct* hc, int nprofiles, profile_struct_annotation* profiles, double cutoff);
 
 /*
- * hc_eval
- *   Evaluates the branched hierarchical solution in terms of the external information-based measure V
- *
- * @reference
- *   Rosenberg and Hirchsberg.
- *   V-Measure : a conditional entropy-based external cluster evaluation measure
- *   EMNLP (2007)
+ * hc_cutoff
+ *   Cutoff value that maximizes the V-measure of the branched hierarchical solution.
+ *   Cutoffs from 0 to the height of the tree are tried in steps of HC_CUTOFF_STEP in one pass over the merges,
+ *   which are applied in order while the V-measure is updated from the merged cells of the contingency table.
+ *   Profiles and distances are not read again and the clusters of the profiles are left untouched.
  *
+ * @arg hcnode_struct* hc
+ *   A pointer to the hierarchical clustering solution, sorted by distance
  * @arg int nprofiles
  *   Total number of profiles
  * @arg profile_struct_annotation* profiles
- *   An array of profiles
- * 
+ *   An array of annotated profiles
+ * @arg FILE* fp
+ *   The file descriptor where the cutoff, number of clusters, homogeneity, completeness and V-measure
+ *   of every cutoff are printed, one per line. NULL to skip the curve.
+ *
  * @return
- *   The V-measure score of the branched hierarchical solution
+ *   The first cutoff with the highest V-measure. -1 if there is not enough memory.
  */
-double hc_eval(int nprofiles, profile_struct_annotation* profiles);
+double hc_cutoff(hcnode_struct* hc, int nprofiles, profile_struct_annotation* profiles, FILE* fp);
@@ -23,6 +23,30 @@ int wcl (FILE *fp);
  */
 int next_profile(FILE* fp, profile_struct_annotation* profile);
 
+/*
+ * prepare_profile
+ *   Initializes the statistics, noise and annotation of a profile whose location and heights are set
+ *
+ * @arg profile_struct_annotation* profile
+ *   Pointer to the profile
+ */
+void prepare_profile(profile_struct_annotation* profile);
+
+/*
+ * parse_feature
+ *   Parses a line of a BED annotation file and stores the contents in a given pointer.
+ *   The line is modified. It is reentrant, so lines can be parsed by several threads at once.
+ *
+ * @arg char* line
+ *   Line of the BED file
+ * @arg feature_struct* feature
+ *   Pointer to the feature where the contents are stored
+ *
+ * @return
+ *   1 if success. -1 if the line is ill-formatted.
+ */
+int parse_feature(char* line, feature_struct* feature);
+
 /*
  * next_feature
  *   Reads a line of the BED annotation file and stores the contents in a given pointer
@@ -36,11 +60,47 @@ int next_feature(FILE* bedf, feature_struct* feature);
 
 /*
  * next_correlation
- *   Reads a line of the correlations file and stores the contents in a given pointer
+ *   Reads a line of the correlations file and stores the contents in a given pointer.
+ *   Distances that were not measured are written as UNMEASURED_PREFIX followed by the
+ *   distance the pair is known to be above, which is the score read.
  *
  * @arg
  *
  * @return
- *   1 if more lines available. 0 if no more lines (EOF). -1 if file is ill-formatted.
+ *   1 if more lines available. 2 if more lines available and the distance was not measured.
+ *   0 if no more lines (EOF). -1 if file is ill-formatted.
  */
 int next_correlation(FILE* xcorrf, double* score);
+
+/*
+ * write_distances_header
+ *   Writes the header line of the distance file: DISTANCES_HEADER_PREFIX followed by the
+ *   metric, the pruning distance and the sparse radius, separated by tabs
+ *
+ * @arg FILE* xcorrf
+ *   Distance file
+ * @arg char* metric
+ *   Name of the metric
+ * @arg double prune
+ *   Pruning distance. 1 if no pair was pruned.
+ * @arg double sparse
+ *   Sparse radius. 0 if all the distances were kept.
+ */
+void write_distances_header(FILE* xcorrf, char* metric, double prune, double sparse);
+
+/*
+ * read_distances_header
+ *   Reads the header line of the distance file. Files without header line, written before
+ *   it was introduced, are left at their first distance.
+ *
+ * @arg FILE* xcorrf
+ *   Distance file
+ * @arg char* metric
+ *   Buffer of MAX_METRIC characters where the name of the metric will be stored
+ * @arg double* prune, double* sparse
+ *   Pointers where the pruning distance and the sparse radius will be stored
+ *
+ * @return
+ *   1 if the header was read. 0 if the file has no header. -1 if the header is ill-formatted.
+ */
+int read_distances_header(FILE* xcorrf, char* metric, double* prune, double* sparse);
@@ -2,45 +2,113 @@
 
 
 /*
- * insert_itnode
- *   A utility function to insert a new Interval Search Tree Node
+ * do_overlap
+ *   Checks if a profile and a feature overlap enough
  *
- * @arg itnode_struct *node
- *   A pointer to the root node of the interval tree
+ * @args int low_a
+ *   Start position of the profile
+ * @args int high_a
+ *   End position of the profile
+ * @args int low_b
+ *   Start position of the feature
+ * @args int high_b
+ *   End position of the feature
+ * @args double overlap_a
+ *   Minimum percentage of the profile that is covered by the feature
+ * @args double overlap_b
+ *   Minimum percentage of the feature that is covered by the profile
+ *
+ * @return
+ *   1 if they overlap enough. 0 otherwise.
+ */
+int do_overlap(int low_a, int high_a, int low_b, int high_b, double overlap_a, double overlap_b);
+
+
+/*
+ * overlap_score
+ *   Annotation score of a feature that overlaps a profile. Profiles keep the annotation with the highest score.
+ *
+ * @args int low_a
+ *   Start position of the profile
+ * @args int high_a
+ *   End position of the profile
+ * @args int low_b
+ *   Start position of the feature
+ * @args int high_b
+ *   End position of the feature
+ *
+ * @return
+ *   The overlap of the profile and the feature, minus the parts of the feature outside the profile
+ */
+int overlap_score(int low_a, int high_a, int low_b, int high_b);
+
+
+/*
+ * itvltree_init
+ *   Initializes an empty interval tree
+ *
+ * @arg itvltree_struct* tree
+ *   A pointer to the interval tree
+ */
+void itvltree_init(itvltree_struct* tree);
+
+
+/*
+ * itvltree_add
+ *   Appends an interval to the tree. The tree has to be built again before it is searched.
+ *
+ * @arg itvltree_struct* tree
+ *   A pointer to the interval tree
  * @arg int low
  *   Lower bound of the new interval
  * @arg int high
  *   Upper bound of the new interval
+ * @arg profile_struct_annotation* profile
+ *   Profile located at the interval
  *
  * @return
- *   The root node of the interval tree
+ *   0 if success. -1 if there is not enough memory.
  */
-itnode_struct* insert_itnode(itnode_struct* node, int low, int high, profile_struct_annotation* profile);
+int itvltree_add(itvltree_struct* tree, int low, int high, profile_struct_annotation* profile);
 
 
 /*
- * search_itnode
- *   Aearches a given interval i in a given interval tree
+ * itvltree_build
+ *   Sorts the intervals and computes the highest end of every implicit subtree, in O(n log n)
  *
- * @arg itnode_struct *node
- *   A pointer to the root node of the interval tree
+ * @arg itvltree_struct* tree
+ *   A pointer to the interval tree
+ */
+void itvltree_build(itvltree_struct* tree);
+
+
+/*
+ * itvltree_search
+ *   Annotates the profiles of all the intervals of the tree that overlap a given interval.
+ *   A profile takes the annotation if the overlap is higher than the one of its current annotation.
+ *   The tree is built first if intervals were added since it was last built.
+ *
+ * @arg itvltree_struct* tree
+ *   A pointer to the interval tree
  * @arg int low
- *   Lower bound of the new interval to be found
+ *   Lower bound of the interval to be found
  * @arg int high
- *   Upper bound of the new interval to be found
- *
- * @return
- *   The index of the profile that overlaps with the interval.
- *   -1 if no profiles overlaps with the interval.
+ *   Upper bound of the interval to be found
+ * @arg char* annotation
+ *   Name of the feature at the interval
+ * @arg double overlap_a
+ *   Minimum percentage of the profile that is covered by the feature
+ * @arg double overlap_b
+ *   Minimum percentage of the feature that is covered by the profile
  */
-void search_itnode(itnode_struct* root, int low, int high, char* annotation, double overlap_a, double overlap_b);
+void itvltree_search(itvltree_struct* tree, int low, int high, char* annotation, double overlap_a, double overlap_b);
 
 
 /*
- * destroy_itnode
- *   Frees all the nodes that are rooted from the given node
+ * itvltree_destroy
+ *   Frees the intervals of the tree
  *
- * @arg itnode_struct *node
- *   A pointer to the root node of the interval tree
+ * @arg itvltree_struct* tree
+ *   A pointer to the interval tree
  */
-void destroy_itnode(itnode_struct* root);
+void itvltree_destroy(itvltree_struct* tree);
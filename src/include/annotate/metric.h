@@ -0,0 +1,81 @@
+#include <core/structs.h>
+#include <annotate/dtw.h>
+#include <annotate/xcorr.h>
+
+/*
+ * Distance metrics between profiles.
+ *
+ * Every metric reports a correlation and the distance between two profiles is one minus it.
+ * A metric may precompute per-profile features once (normalized copies, ranks...) so that
+ * the pairwise kernel does the minimum work. Metrics that compare profiles point by point
+ * work on profiles resampled to METRIC_LENGTH segments, so profiles of any length can be compared.
+ *
+ * Pairs of profiles can only be pruned before the distance is calculated (see prune.h) for
+ * metrics flagged as prunable.
+ *
+ * Registered metrics:
+ *   xdtw     : X-Correlation-based dynamic time warping. Prunable.
+ *   nxcorr   : Normalized X-Correlation over lags
+ *   adtw     : X-Correlation of the standard dynamic time warping alignment
+ *   dtw      : Sakoe-Chiba dynamic time warping cost
+ *   euclid   : Euclidean distance between profiles scaled to unit maximum height
+ *   pearson  : Pearson correlation
+ *   spearman : Spearman rank correlation
+ *   kendall  : Kendall's tau-b
+ */
+
+/*
+ * metric_find
+ *   Looks for a metric by name
+ *
+ * @arg char* name
+ *   Name of the metric
+ *
+ * @return
+ *   Index of the metric in the registry. -1 if there is no metric with that name.
+ */
+int metric_find(char* name);
+
+/*
+ * metric_get
+ *   Gets a metric of the registry
+ *
+ * @arg int index
+ *   Index of the metric, as returned by metric_find
+ *
+ * @return
+ *   Pointer to the metric
+ */
+metric_struct* metric_get(int index);
+
+/*
+ * metric_prepare
+ *   Precomputes the features of a profile used by a metric
+ *
+ * @arg metric_struct* metric
+ *   Distance metric
+ * @arg profile_struct_annotation* profile
+ *   Profile
+ * @arg features_struct* features
+ *   Pointer to the features where results will be stored
+ */
+void metric_prepare(metric_struct* metric, profile_struct_annotation* profile, features_struct* features);
+
+/*
+ * metric_correlation
+ *   Correlation between two profiles
+ *
+ * @arg metric_struct* metric
+ *   Distance metric
+ * @arg profile_struct_annotation* p1, features_struct* f1
+ *   First profile and its features
+ * @arg profile_struct_annotation* p2, features_struct* f2
+ *   Second profile and its features
+ * @arg double bound
+ *   Minimum correlation of interest. Metrics that support it may stop early and
+ *   return XDTW_ABANDONED when the correlation is lower. -INFINITY to get the exact value.
+ *
+ * @return
+ *   Correlation between the profiles
+ */
+double metric_correlation(metric_struct* metric, profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound);
@@ -0,0 +1,49 @@
+#include <core/structs.h>
+#include <core/parallel.h>
+#include <annotate/graph.h>
+
+/*
+ * nn_build
+ *   Builds the sorted neighbour lists of all the points in a distance matrix.
+ *   Lists are truncated at a given radius, so only neighbours j of point i
+ *   that satisfy dist(i,j) <= radius are stored. Rows are processed in parallel.
+ *
+ * @arg double** dist
+ *   Distance/dissimilarity matrix
+ * @arg int n
+ *   Number of elements in dist
+ * @arg double radius
+ *   Maximum distance between a point and its neighbours
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   A pointer to a newly allocated nnlist_struct. NULL if not enough memory.
+ */
+nnlist_struct* nn_build(double** dist, int n, double radius, int nthreads);
+
+/*
+ * nn_build_graph
+ *   Same as nn_build for a sparse distance graph. Pairs that are not stored in the
+ *   graph are never neighbours.
+ *
+ * @arg graph_struct* graph
+ *   Finalized sparse distance graph
+ * @arg double radius
+ *   Maximum distance between a point and its neighbours
+ * @arg int nthreads
+ *   Number of worker threads
+ *
+ * @return
+ *   A pointer to a newly allocated nnlist_struct. NULL if not enough memory.
+ */
+nnlist_struct* nn_build_graph(graph_struct* graph, double radius, int nthreads);
+
+/*
+ * nn_destroy
+ *   Frees a neighbour list struct
+ *
+ * @arg nnlist_struct* nn
+ *   Pointer to the neighbour lists
+ */
+void nn_destroy(nnlist_struct* nn);
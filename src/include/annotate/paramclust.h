@@ -1,4 +1,5 @@
 #include <core/structs.h>
+#include <annotate/metric.h>
 
 /*
  * parse_command_line
@@ -17,6 +18,21 @@
  */
 int parse_command_line_c(int argc, char** argv, char** error_message, args_a_struct* arguments);
 
+/*
+ * check_annotate_arguments
+ *   Checks the annotate options that depend on each other once they are all parsed.
+ *   Hierarchical clustering without a cutoff needs an annotation, is not run on sparse distances,
+ *   and pruning needs a metric that can abandon distances early.
+ *
+ * @args args_a_struct* arguments
+ *   Pointer to the argument handler
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int check_annotate_arguments(args_a_struct* arguments, char** error_message);
+
 /*
  * parse_annotation_parameters
  *   Parses the string defining the annotation file option
@@ -53,3 +69,78 @@ int parse_overlapping_parameters(char* option, char** error_message, args_a_stru
  *
  */
 int parse_xcorr_parameters(char* option, char** error_message, args_a_struct* arguments);
+
+/*
+ * parse_threads_parameters
+ *   Parses the string defining the number of worker threads
+ *
+ * @arg char* option
+ *   String defining the number of threads
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_a_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_threads_parameters(char* option, char** error_message, args_a_struct* arguments);
+
+/*
+ * parse_prune_parameters
+ *   Parses the string defining the pruning distance
+ *
+ * @arg char* option
+ *   String defining the pruning distance
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_a_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_prune_parameters(char* option, char** error_message, args_a_struct* arguments);
+
+/*
+ * parse_sparse_parameters
+ *   Parses the string defining the radius of the sparse distance graph
+ *
+ * @arg char* option
+ *   String defining the radius
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_a_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_sparse_parameters(char* option, char** error_message, args_a_struct* arguments);
+
+/*
+ * parse_metric_parameters
+ *   Parses the string defining the distance metric between profiles
+ *
+ * @arg char* option
+ *   String defining the distance metric
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_a_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_metric_parameters(char* option, char** error_message, args_a_struct* arguments);
+
+/*
+ * parse_clustering_parameters
+ *   Parses the string defining the clustering method and, for hierarchical clustering, the cutoff to branch the tree
+ *
+ * @arg char* option
+ *   String defining the clustering method
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_a_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_clustering_parameters(char* option, char** error_message, args_a_struct* arguments);
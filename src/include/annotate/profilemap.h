@@ -1,3 +1,4 @@
+#include <core/chrdict.h>
 #include <annotate/itvltree.h>
 
 /*
@@ -9,27 +10,21 @@
  */
 void map_init(map_struct* map);
 
-/*
- * map_sort
- *   Sorts the profile map
- *
- * @arg map_struct* map
- *   Pointer to a profile map
- */
-void map_sort(map_struct* map);
-
 /*
  * map_search
- *   Searches a profile within the map
+ *   Searches a chromosome and strand within the map. The chromosome is looked up in the
+ *   chromosome dictionary of the map, so the search takes constant time.
  *
  * @arg map_struct* map
  *   Pointer to a profile map
- * @arg profile_struct* profile
- *   The profile to be found
+ * @arg char* chrom
+ *   Chromosome to be found
+ * @arg int strand
+ *   Strand to be found
  *
  * @return
- *   The index of the profile within the map.
- *   -1 if profile is not in the map.
+ *   The index of the chromosome and strand within the map.
+ *   -1 if the chromosome is not in the map.
  */
 int map_search(map_struct* map, char* chrom, int strand);
 
@@ -44,6 +39,15 @@ int map_search(map_struct* map, char* chrom, int strand);
  */
 void map_add_profile(map_struct* map, profile_struct_annotation* profile);
 
+/*
+ * map_build
+ *   Builds the interval trees of the map once all the profiles have been added
+ *
+ * @arg map_struct* map
+ *   Pointer to a profile map
+ */
+void map_build(map_struct* map);
+
 /*
  * map_annotate
  *   Annotates a profile in the map
@@ -63,6 +67,22 @@ void map_add_profile(map_struct* map, profile_struct_annotation* profile);
  */
 void map_annotate(args_a_struct* arguments, map_struct* map, char* chrom, int start, int end, int strand, char* feature);
 
+/*
+ * map_annotate_batch
+ *   Annotates the profiles in the map with a batch of features, in the order of the batch.
+ *   The result is the same as calling map_annotate on every feature.
+ *
+ * @args args_a_struct* arguments
+ *   Pointer to a struct handling the command line parameters
+ * @args map_struct* map
+ *   Pointer to a profile map
+ * @args feature_struct* features
+ *   Features for annotation
+ * @args long nfeatures
+ *   Number of features
+ */
+void map_annotate_batch(args_a_struct* arguments, map_struct* map, feature_struct* features, long nfeatures);
+
 /*
  * map_destroy
  *   Destroys a map
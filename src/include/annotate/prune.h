@@ -0,0 +1,43 @@
+#include <core/structs.h>
+
+/*
+ * Candidate pruning before DTW.
+ *
+ * xdtw aligns every position i >= 1 of the first profile once, either with a position j >= 1
+ * of the second profile within the band |i - j| <= |n - m| or with a gap filled with noise,
+ * and every position j >= 1 of the second profile is aligned with a gap at most once. The
+ * cross product of the alignment is then at most the sum, over the positions of one profile,
+ * of the largest product with the band of the other profile or with the largest noise, plus
+ * the largest noise of the first profile times the absolute heights of the second one. Gaps
+ * only add energy to both signals, so this sum over the norms of the profiles is an upper
+ * bound of the correlation xdtw can reach with any noise drawn, and one minus it is a lower
+ * bound of the xdtw distance. Pairs whose bound is above the pruning distance are known to be
+ * farther than it and do not need to be aligned.
+ *
+ * The bound only holds for xdtw.
+ */
+
+/*
+ * prune_build
+ *   Precomputes the terms of the bound that only depend on a profile
+ *
+ * @arg profile_struct_annotation* profile
+ *   Profile
+ * @arg prune_struct* prune
+ *   Pointer to the struct where results will be stored
+ */
+void prune_build(profile_struct_annotation* profile, prune_struct* prune);
+
+/*
+ * prune_distance
+ *   Lower bound of the xdtw distance between two profiles
+ *
+ * @arg profile_struct_annotation* p1, prune_struct* b1
+ *   First profile and its precomputed terms
+ * @arg profile_struct_annotation* p2, prune_struct* b2
+ *   Second profile and its precomputed terms
+ *
+ * @return
+ *   A value between 0 and 1, lower or equal than the xdtw distance between the profiles
+ */
+double prune_distance(profile_struct_annotation* p1, prune_struct* b1, profile_struct_annotation* p2, prune_struct* b2);
@@ -0,0 +1,24 @@
+#include <core/parallel.h>
+#include <core/chrdict.h>
+#include <annotate/itvltree.h>
+
+/*
+ * sweep_annotate
+ *   Annotates profiles with the features that overlap them by sorting both by chromosome, strand and start
+ *   and sweeping every chromosome and strand once. Chromosomes and strands are swept in parallel.
+ *
+ *   The result is the same as annotating the profiles with every feature in order through the profile map:
+ *   a profile keeps the feature with the highest overlap score, and the first one of them if there are ties.
+ *
+ * @arg args_a_struct* arguments
+ *   Pointer to a struct handling the command line parameters
+ * @arg profile_struct_annotation* profiles
+ *   Array of profiles
+ * @arg int nprofiles
+ *   Number of profiles
+ * @arg feature_struct* features
+ *   Array of features in the order of the annotation files
+ * @arg long nfeatures
+ *   Number of features
+ */
+void sweep_annotate(args_a_struct* arguments, profile_struct_annotation* profiles, int nprofiles, feature_struct* features, long nfeatures);
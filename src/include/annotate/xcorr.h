@@ -1,4 +1,5 @@
 #include <core/structs.h>
+#include <gsl/gsl_fft_complex.h>
 
 /*
  * Calculate the deterministic cross-correlation between two deterministic
@@ -7,6 +8,11 @@
  * The correlation is normalized so that the auto-correlations at 
  * 0 lag are identically 1.0
  *
+ * Gaps of the shortest signal are filled with noise drawn once per position.
+ * Energy and noise terms of every lag come from prefix sums, and the overlapping
+ * part is correlated for all lags in one pass (directly for short signals and
+ * through the FFT for signals of XCORR_FFT_LENGTH or more).
+ *
  * @reference: Orfanidis, "Optimum Signal Processing. An Introduction"
  *             2nd Ed. Macmillan, 1988.
  *
@@ -0,0 +1,69 @@
+#ifndef CHRDICT_H
+#define CHRDICT_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <core/constants.h>
+#include <core/structs.h>
+
+/*
+ * chrdict_init
+ *   Initializes an empty chromosome dictionary
+ *
+ * @arg chrdict_struct* dict
+ *   Pointer to a chromosome dictionary
+ */
+void chrdict_init(chrdict_struct* dict);
+
+/*
+ * chrdict_find
+ *   Looks up the identifier of a chromosome name
+ *
+ * @arg chrdict_struct* dict
+ *   Pointer to a chromosome dictionary
+ * @arg const char* name
+ *   Name of the chromosome
+ *
+ * @return
+ *   The identifier of the chromosome. -1 if it is not in the dictionary.
+ */
+int chrdict_find(const chrdict_struct* dict, const char* name);
+
+/*
+ * chrdict_intern
+ *   Interns a chromosome name. Identifiers are given in order of insertion, starting at 0,
+ *   so a dictionary seeded with the targets of a BAM header gives the same identifiers as the header.
+ *
+ * @arg chrdict_struct* dict
+ *   Pointer to a chromosome dictionary
+ * @arg const char* name
+ *   Name of the chromosome
+ *
+ * @return
+ *   The identifier of the chromosome. -1 if there is not enough memory.
+ */
+int chrdict_intern(chrdict_struct* dict, const char* name);
+
+/*
+ * chrdict_name
+ *   Name of a chromosome identifier
+ *
+ * @arg chrdict_struct* dict
+ *   Pointer to a chromosome dictionary
+ * @arg int id
+ *   Identifier of the chromosome
+ *
+ * @return
+ *   The name of the chromosome
+ */
+const char* chrdict_name(const chrdict_struct* dict, int id);
+
+/*
+ * chrdict_destroy
+ *   Frees the memory held by a chromosome dictionary
+ *
+ * @arg chrdict_struct* dict
+ *   Pointer to a chromosome dictionary
+ */
+void chrdict_destroy(chrdict_struct* dict);
+#endif
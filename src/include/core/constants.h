@@ -79,6 +79,22 @@
  */
 #define REPLICATE_NUMBER 1
 
+/*
+ * Default value for batch mode. Samples are read from a sample sheet when enabled.
+ */
+#define BATCH_CONDITION 0
+
+/*
+ * Default memory budget, in megabytes, of the samples processed at once in batch mode.
+ * 0 is the physical memory of the machine.
+ */
+#define BATCH_MEMORY 0
+
+/*
+ * Initial capacity of the list of samples read from a sample sheet
+ */
+#define SAMPLE_SHEET_CAPACITY 16
+
 /*
  * Replicate treatment options
  */
@@ -151,6 +167,11 @@
  */
 #define MAX_BLOCK 3000
 
+/*
+ * Initial capacity of the lists of profiles built in memory
+ */
+#define PROFILE_LIST_CAPACITY 1024
+
 /*
  * Alignment strand
  */
@@ -187,6 +208,7 @@
 #define CLUSTERS_SUFFIX "clusters.neWick"
 #define ANNOTATION_O_SUFFIX "annotation.bed" 
 #define TMPROFILES_SUFFIX "tmprofiles.dat"
+#define VMEASURE_SUFFIX "vmeasure.dat"
 
 /*
  * Maximum N limit for gaussian white noise generation
@@ -194,10 +216,41 @@
 #define MAX_GNOISE_N 20
 
 /*
- * Cluster cutoff default value
+ * Cluster cutoff default value. Negative values select the cutoff with the best V-measure.
  */
 #define CLUSTER_CUTOFF -1.0f
 
+/*
+ * Clustering methods
+ */
+#define CLUSTERING_DPCLUST 0
+#define CLUSTERING_HIERARCHICAL 1
+
+/*
+ * Default clustering method
+ */
+#define CLUSTERING_METHOD CLUSTERING_DPCLUST
+
+/*
+ * Step between the cutoffs tried when branching hierarchical clustering solutions
+ */
+#define HC_CUTOFF_STEP 0.01
+
+/*
+ * Entropies below this value are taken as 0 when the V-measure is updated incrementally
+ */
+#define VMEASURE_EPSILON 1e-12
+
+/*
+ * Minimum number of active clusters for splitting hierarchical clustering steps between threads
+ */
+#define HC_PARALLEL_SIZE 16384
+
+/*
+ * Size in bytes of the buffer for writing neWick trees
+ */
+#define NEWICK_BUFFER 65536
+
 /*
  * Condition for existence of annotation file
  */
@@ -223,11 +276,89 @@
  */
 #define MAX_ANNOTATIONS 10
 
+/*
+ * Condition for annotating with a sort-and-sweep pass instead of the profile map
+ */
+#define SWEEP_CONDITION 0
+
+/*
+ * Initial number of intervals allocated by an interval tree
+ */
+#define ITVLTREE_CAPACITY 64
+
+/*
+ * Initial number of slots of a chromosome dictionary
+ */
+#define CHRDICT_CAPACITY 64
+
+/*
+ * Size in bytes of the chunks of annotation files parsed in parallel
+ */
+#define BED_CHUNK_SIZE (1 << 22)
+
+/*
+ * Initial number of features allocated for a chunk of an annotation file
+ */
+#define BED_CHUNK_FEATURES 1024
+
 /*
  * Condition for existence of correlations file
  */
 #define CORRELATIONS_CONDITION 0
 
+/*
+ * Default pruning distance. Pairs of profiles whose lower bound of the distance is above it
+ * are not aligned. 1 disables pruning.
+ */
+#define PRUNE_DISTANCE 1.0
+
+/*
+ * Value returned by xdtw_bounded when the alignment is abandoned. Lower than any correlation.
+ */
+#define XDTW_ABANDONED -2.0
+
+/*
+ * Signals of at least this length are cross-correlated through the FFT by nxcorr
+ */
+#define XCORR_FFT_LENGTH 256
+
+/*
+ * Default distance metric between profiles
+ */
+#define DISTANCE_METRIC "xdtw"
+
+/*
+ * Number of segments of the resampled profiles used by point by point metrics
+ */
+#define METRIC_LENGTH 64
+
+/*
+ * Default radius of the sparse distance graph. 0 keeps all the distances in a dense matrix.
+ */
+#define SPARSE_RADIUS 0
+
+/*
+ * Distance stored for pairs of profiles that are pruned
+ */
+#define PRUNED_DISTANCE 1.0
+
+/*
+ * Prefix of the distances of the distance file that are not measured, followed by the
+ * distance the pair is known to be above
+ */
+#define UNMEASURED_PREFIX '>'
+
+/*
+ * Prefix of the header line of the distance file, followed by the metric, the pruning
+ * distance and the sparse radius the distances were calculated with
+ */
+#define DISTANCES_HEADER_PREFIX '#'
+
+/*
+ * Maximum length of the name of a distance metric
+ */
+#define MAX_METRIC 32
+
 /*
  * Constants for profile category
  */
@@ -239,6 +370,11 @@
  */
 #define P_VALUE 0.01
 
+/*
+ * Largest sample size for which the exact distribution of the Mann-Whitney U statistic is used
+ */
+#define MANNWHITNEY_EXACT_SIZE 20
+
 /*
  * Differential processing default overlap
  */
@@ -252,4 +388,61 @@
  * Suffix for differentially processed clusters
  */
 #define DIFFPROC_CLUSTER_O_SUFFIX "diffclusters.dat"
+
+/*
+ * Default number of worker threads
+ */
+#define THREADS 1
+
+/*
+ * Stack size, in bytes, of worker threads. Must hold the DTW matrices kept on the stack
+ */
+#define THREAD_STACK_SIZE (16 * 1024 * 1024)
+
+/*
+ * Radius of the neighbour lists used by dpClust, in multiples of the distance cutoff (dc)
+ */
+#define NN_RADIUS 2.0
+
+/*
+ * Default multiple of dc beyond which gaussian density contributions are ignored.
+ * 0 to add all the contributions.
+ */
+#define KERNEL_TRUNCATION 0
+
+/*
+ * Number of distances gathered per block by the density calculation
+ */
+#define DENSITY_BLOCK 256
+
+/*
+ * Default increment of the impact factor (sigma) scanned by the dc optimization
+ */
+#define DC_TOLERANCE 0.005
+
+/*
+ * Minimum increment of the impact factor (sigma) accepted by the dc optimization.
+ * Smaller increments are lost when added to sigma in single precision.
+ */
+#define DC_MIN_TOLERANCE 1e-6
+
+/*
+ * Number of bins per point of the distance histograms used by the dc optimization
+ */
+#define DC_BINS 256
+
+/*
+ * Range of the distance histograms, in multiples of the upper boundary for sigma
+ */
+#define DC_KERNEL_RANGE 4.0
+
+/*
+ * Number of values of sigma evaluated to bracket the minimum entropy
+ */
+#define DC_SCAN 16
+
+/*
+ * Number of bins of the histograms used to locate quantiles of pairwise distances
+ */
+#define QUANTILE_BINS 4096
 #endif
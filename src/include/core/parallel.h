@@ -0,0 +1,53 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <pthread.h>
+#include <core/constants.h>
+
+/*
+ * Task executed by parallel_for for every index in the iteration range
+ *
+ * @arg int index
+ *   Index of the iteration being executed
+ * @arg int thread
+ *   Identifier of the worker thread executing the iteration (0 to nthreads - 1)
+ * @arg void* data
+ *   Shared data provided by the caller
+ */
+typedef void (*parallel_task)(int index, int thread, void* data);
+
+/*
+ * parallel_threads
+ *   Number of worker threads that will be actually used for a given number of iterations
+ *
+ * @arg int n
+ *   Number of iterations
+ * @arg int nthreads
+ *   Number of threads requested by the user
+ *
+ * @return
+ *   The number of worker threads, between 1 and nthreads
+ */
+int parallel_threads(int n, int nthreads);
+
+/*
+ * parallel_for
+ *   Executes a task for every index between 0 and n - 1 using a pool of worker threads.
+ *   Indexes are handed out dynamically in ascending order and in chunks of the given size,
+ *   so callers can schedule expensive iterations first by ordering them accordingly.
+ *   The iterations are run in the calling thread when nthreads is 1.
+ *
+ * @arg int n
+ *   Number of iterations
+ * @arg int nthreads
+ *   Number of worker threads
+ * @arg int chunk
+ *   Number of consecutive iterations handed out to a worker at once. Must be > 0.
+ * @arg parallel_task task
+ *   Task to execute for each iteration
+ * @arg void* data
+ *   Shared data passed to every task
+ */
+void parallel_for(int n, int nthreads, int chunk, parallel_task task, void* data);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef QUANTILE_H
+#define QUANTILE_H
+
+#include <stdlib.h>
+#include <float.h>
+#include <core/constants.h>
+
+/*
+ * quantile_select
+ *   Quantile of an unsorted array, interpolated as in gsl_stats_quantile_from_sorted_data.
+ *   Elements are selected with introselect (quickselect falling back to sorting when the
+ *   recursion gets too deep), so the array is partially reordered.
+ *
+ * @arg double* data
+ *   Array of values. It is reordered.
+ * @arg long n
+ *   Number of elements in data
+ * @arg double f
+ *   Quantile, between 0 and 1
+ *
+ * @return
+ *   The quantile f of data. 0 if data is empty.
+ */
+double quantile_select(double* data, long n, double f);
+
+/*
+ * quantile_pairs
+ *   Summary of the distances between all the pairs of elements in a distance matrix,
+ *   obtained without copying the n(n-1)/2 distances. Extremes are found in a first pass,
+ *   a histogram of QUANTILE_BINS bins locates the ranks of the quantile in a second pass
+ *   and only the distances in those bins are gathered and selected in a third pass.
+ *
+ * @arg double** dist
+ *   Distance/dissimilarity matrix
+ * @arg int n
+ *   Number of elements in dist. Must be > 1.
+ * @arg double f
+ *   Quantile, between 0 and 1
+ * @arg double* lower
+ *   Pointer to a double variable where the minimum non-zero distance will be stored
+ * @arg double* max
+ *   Pointer to a double variable where the maximum distance will be stored
+ *
+ * @return
+ *   The quantile f of the distances, interpolated as in gsl_stats_quantile_from_sorted_data
+ */
+double quantile_pairs(double** dist, int n, double f, double* lower, double* max);
+
+#endif
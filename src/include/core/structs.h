@@ -23,6 +23,10 @@ typedef struct {
   double trim_threshold;
   int trim_min;
   int trim_max;
+  int batch;
+  char batch_f_path[MAX_PATH];
+  int threads;
+  long memory;
 } args_p_struct;
 
 /*
@@ -36,13 +40,30 @@ typedef struct {
   //char species[MAX_FEATURE];
   //int additional_profiles;
   //char additional_profiles_f_path[MAX_PATH];
-  //double cluster_cutoff;
   double overlap_ftop;
   double overlap_ptof;
   int correlations;
   char correlations_f_path[MAX_PATH];
+  int threads;
+  double prune;
+  double sparse;
+  int metric;
+  int sweep;
+  int clustering;
+  double cluster_cutoff;
+  double dc_tolerance;
+  double kernel_truncation;
 } args_a_struct;
 
+/*
+ * Struct for handling run command line arguments
+ * The output folder of both stages is the same
+ */
+typedef struct {
+  args_p_struct profiles;
+  args_a_struct annotate;
+} args_r_struct;
+
 /*
  * Struct for handling diffproc command line arguments
  */
@@ -54,6 +75,12 @@ typedef struct {
   char clusters_b_f_path[MAX_PATH];
   double pvalue;
   double foldchange;
+  int metric;
+  int threads;
+  int distances;
+  char distances_a_f_path[MAX_PATH];
+  char distances_b_f_path[MAX_PATH];
+  int streaming;
 } args_d_struct;
 
 /*
@@ -100,8 +127,45 @@ typedef struct {
   int32_t category;
 } profile_struct_annotation;
 
+/*
+ * Struct for handling lists of profiles built in memory
+ */
+typedef struct {
+  profile_struct_annotation* profiles;
+  int size;
+  int capacity;
+} profile_list_struct;
+
+/*
+ * Struct for handling the terms of a profile used to bound its xdtw distances for pruning
+ */
+typedef struct {
+  double energy;
+  double mass;
+  double noise;
+} prune_struct;
+
+/*
+ * Struct for handling the features of a profile precomputed by a distance metric
+ */
+typedef struct {
+  double values[METRIC_LENGTH];
+} features_struct;
+
+/*
+ * Struct for handling a distance metric between profiles
+ */
+typedef struct {
+  char* name;
+  void (*prepare)(profile_struct_annotation* profile, features_struct* features);
+  double (*correlation)(profile_struct_annotation* p1, features_struct* f1, profile_struct_annotation* p2, features_struct* f2, double bound);
+  int prunable;
+} metric_struct;
+
 /*
  * Struct for handling sRNA profiles during differential processing analysis
+ * profile, noise and features are only allocated while the cluster of the profile is loaded.
+ * offset is the position of the profile in its profile file.
  */
 struct profile_struct_diffproc {
   double *profile;
@@ -111,19 +175,23 @@ struct profile_struct_diffproc {
   int length;
   int32_t strand;
   char annotation[MAX_FEATURE];
-  double noise[MAX_PROFILE_LENGTH];
+  double* noise;
   int differential;
   int cluster;
   int position;
+  long offset;
+  features_struct* features;
   struct profile_struct_diffproc* partner;
 };
 typedef struct profile_struct_diffproc profile_struct_diffproc;
 
 /*
  * Struct for handling BAM alighment
+ * tid is the index of the chromosome in the target names of the BAM header
  */
 typedef struct {
   char chromosome[MAX_FEATURE];
+  int32_t tid;
   int32_t start;
   int32_t end;
   int32_t strand;
@@ -134,12 +202,14 @@ typedef struct {
 
 /*
  * Struct for handling contigs
+ * tid is the index of the chromosome in the target names of the BAM header
  */
 typedef struct {
   int start;
   int end;
   double *profile;
   char chromosome[MAX_FEATURE];
+  int32_t tid;
   int* nreads;
 } contig_struct;
 
@@ -159,33 +229,52 @@ typedef unsigned long count_t;
 
 /*
  * Structure for handling nodes of interval trees
+ * max is the highest end of the intervals in the subtree rooted at the node
  */
-struct itnode_struct {
+typedef struct {
   int low;
   int high;
+  int max;
   profile_struct_annotation* profile;
-  struct itnode_struct* left;
-  struct itnode_struct* right;
-  int height;
-};
+} itnode_struct;
+
+/*
+ * Structure for handling static interval trees
+ * Nodes are sorted by low. The subtree of nodes [a, b) is implicit and rooted at node (a + b) / 2.
+ * Nodes are appended in any order and the tree is built once all of them have been added.
+ */
+typedef struct {
+  itnode_struct* nodes;
+  int size;
+  int capacity;
+  int built;
+} itvltree_struct;
 
 /*
- * Typedef for interval tree node
+ * Structure for handling chromosome dictionaries
+ * Names are interned to consecutive identifiers. slots is an open addressing hash table
+ * of identifiers, -1 for empty slots, with capacity slots (a power of two) at most half full.
  */
-typedef struct itnode_struct itnode_struct;
+typedef struct {
+  char (*names)[MAX_FEATURE];
+  int* slots;
+  int size;
+  int capacity;
+} chrdict_struct;
 
 /*
  * Structure for handling elements of profiles maps
  */
 typedef struct {
-  char identifier[MAX_FEATURE];
-  itnode_struct* root;
+  itvltree_struct tree;
 } map_element_struct;
 
 /*
  * Structure for handling profile maps
+ * The element of chromosome identifier id and strand s is elements[2 * id + s].
  */
 typedef struct {
+  chrdict_struct chromosomes;
   map_element_struct* elements;
   int size;
 } map_struct;
@@ -266,19 +355,72 @@ typedef struct {
 } annotation_struct;
 
 /*
- * Struct for non-parametric stats
+ * Struct for dp clustering
  */
 typedef struct {
   double value;
-  double adjidx;
-  int sample;
-} npstats_struct;
+  int index;
+} rho_struct;
 
 /*
- * Struct for dp clustering
+ * Struct for a neighbour in a neighbour list
  */
 typedef struct {
-  double value;
+  double distance;
   int index;
-} rho_struct;
+} neighbour_struct;
+
+/*
+ * Struct for sparse distance graphs (CSR layout)
+ * Only distances <= radius are stored. Pairs that are not stored are at distance sentinel.
+ * Neighbours of point i are stored in positions offset[i] to offset[i + 1] - 1, sorted by
+ * ascending index. Pairs are buffered in insertion order until the graph is finalized.
+ */
+typedef struct {
+  int n;
+  double radius;
+  double sentinel;
+  long nedges;
+  long capacity;
+  int* first;
+  int* second;
+  double* weight;
+  long* offset;
+  int* index;
+  double* distance;
+} graph_struct;
+
+/*
+ * Struct for neighbour lists truncated at a given radius (CSR layout)
+ * Neighbours of point i are stored in positions offset[i] to offset[i + 1] - 1,
+ * sorted by ascending distance and index
+ */
+typedef struct {
+  int n;
+  double radius;
+  long* offset;
+  neighbour_struct* neighbours;
+} nnlist_struct;
+
+/*
+ * Struct for the sorted distribution of pairwise distances between active points
+ * A Fenwick tree over the sorted distances counts the pairs whose points are both active
+ * When built from a sparse graph, active pairs that are not stored are at distance sentinel
+ * Distances are kept in single precision. Every pair takes 16 bytes: value, rank and Fenwick count.
+ */
+typedef struct {
+  int n;
+  int nactive;
+  long size;
+  long npairs;
+  long nzeros;
+  long step;
+  double sentinel;
+  float* value;
+  long* rank;
+  int* tree;
+  int* active;
+  long* pair;
+  graph_struct* graph;
+} distribution_struct;
 #endif
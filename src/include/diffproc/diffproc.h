@@ -1,4 +1,6 @@
-#include <annotate/dtw.h>
+#include <core/parallel.h>
+#include <annotate/metric.h>
+#include <annotate/iofile.h>
 #include <diffproc/paramdiff.h>
 #include <diffproc/diffprocio.h>
 #include <diffproc/npstats.h>
@@ -22,6 +22,18 @@ int next_diffproc_feature(FILE* bedf, feature_struct_diffproc* feature);
  */
 int next_diffproc_profile(FILE* fp, profile_struct_diffproc* profile);
 
+/*
+ * next_diffproc_location
+ *   Reads a line of the profile file and stores the location of the profile and the offset of the line
+ *   in a given pointer. Heights are skipped, and profile, noise and features are set to NULL.
+ *
+ * @arg
+ *
+ * @return
+ *   1 if more lines available. 0 if no more lines. -1 if file is ill-formatted.
+ */
+int next_diffproc_location(FILE* fp, profile_struct_diffproc* profile);
+
 /*
  * find_clusters
  *   Reads all the lines in a BED cluster file and returns the numbe of clusters
@@ -1,26 +1,65 @@
 #include <core/structs.h>
 
 /*
- * Perform Mann-Whitney U test on two independent samples using direct method
+ * Computes the Mann-Whitney U statistic of the first sample in O(n + m) by merging both samples
  *
  * For each observation in one sample, count the number of times this first value is higher than any other observation in the other sample (win). Count 0.5 if observations are equal (tie).
- * The sum of wins and ties is U for the first sample. U for the other sample is the converse.
+ * The sum of wins and ties is U for the first sample. U for the other sample is the converse:
+ *   U1 + U2 = n * m
  *
- * Being n and m the size of the first and second samples respectively, and U1 and U2 the U statitics of the first and the second samples respectively:
- *   U1 = n * m - U2
- *   U2 = n * m - U1
- *   U = min(U1, U2)
+ * @reference https://en.wikipedia.org/wiki/Mann%E2%80%93Whitney_U_test
+ *
+ * @arg double* p
+ *   All the observations in the first sample, sorted in ascending order
+ * @arg int n
+ *   Number of observations in the first sample
+ * @arg double* q
+ *   All the observations in the second sample, sorted in ascending order
+ * @arg int m
+ *   Number of observations in the second sample
+ *
+ * @return
+ *   U statistic of the first sample
+ */
+double mannwhitney_u (double* p, int n, double* q, int m);
+
+/*
+ * Exact cumulative distribution of the Mann-Whitney U statistic under the null hypothesis, without ties
  *
- * If U <= Ucritical then null hypothesis is rejected at a chosen alpha level.
+ * The frequencies of U are the coefficients of the Gaussian binomial coefficient [n + m, n],
+ * expanded in O(n * n * m) from its product form.
+ *
+ * @reference Mann and Whitney. 1947.
+ *
+ * @arg int n
+ *   Number of observations in the first sample. At most MANNWHITNEY_EXACT_SIZE.
+ * @arg int m
+ *   Number of observations in the second sample. At most MANNWHITNEY_EXACT_SIZE.
+ * @arg double u
+ *   Value of the U statistic
+ *
+ * @return
+ *   P(U <= u)
+ */
+double mannwhitney_exact (int n, int m, double u);
+
+/*
+ * Perform Mann-Whitney U test on two independent samples using the exact distribution of U
+ *
+ * U of the first sample is computed with mannwhitney_u. The null hypothesis is rejected in favour of the
+ * first sample being stochastically lower if P(U <= Up) <= pval. Ties are counted as half wins, so Up is
+ * conservatively rounded up before looking up the exact distribution.
+ *
+ * Samples larger than MANNWHITNEY_EXACT_SIZE are tested with mannwhitney_i.
  *
  * @reference https://en.wikipedia.org/wiki/Mann%E2%80%93Whitney_U_test
  *
  * @arg double* p
- *   All the observations in the first sample
+ *   All the observations in the first sample, sorted in ascending order
  * @arg int n
  *   Number of observations in the first sample
  * @arg double* q
- *   All the observations in the second sample
+ *   All the observations in the second sample, sorted in ascending order
  * @arg int m
  *   Number of observations in the second sample
  * @arg double pval
@@ -32,8 +71,9 @@
 int mannwhitney_d (double* p, int n, double* q, int m, double pval);
 
 /*
- * Perform Mann-Whitney U test on two independent samples using indirect method
+ * Perform Mann-Whitney U test on two independent samples using the normal approximation
  *
+ * U of the first sample is computed with mannwhitney_u, which is the same as ranking:
  * Being n and m the size of the first and second samples respectively:
  *   1. Assign numeric ranks to all the observations in both samples, beginning with 1 for the smallest value.
  *      Where there are groups of tied values, assign a rank equal to the midpoint of unadjusted rankings [e.g., the ranks of (3, 5, 5, 9) are (1, 2.5, 2.5, 4)].
@@ -54,25 +94,25 @@ int mannwhitney_d (double* p, int n, double* q, int m, double pval);
  * @reference https://en.wikipedia.org/wiki/Mann%E2%80%93Whitney_U_test
  *
  * @arg double* p
- *   All the observations in the first sample
+ *   All the observations in the first sample, sorted in ascending order
  * @arg int n
  *   Number of observations in the first sample
  * @arg double* q
- *   All the observations in the second sample
+ *   All the observations in the second sample, sorted in ascending order
  * @arg int m
  *   Number of observations in the second sample
  * @arg double pval
  *   Desired p-value of the given test
  *
  * @return
- *   Mann-Whitney U test p-value
+ *   1 if the null hipothesis is rejected with a p-value <= pval. 0 otherwise.
  */
 int mannwhitney_i (double* p, int n, double* q, int m, double pval);
 
 /*
  * Tests applicability of Mann-Whitney U Test based on the size of the samples and the alpha level (p-value)
- * 
- * @reference http://math.usask.ca/~laverty/S245/Tables/wmw.pdf
+ *
+ * The test is applicable if the lowest p-value it can reach, P(U = 0) = 1 / C(n + m, n), is <= pval
  *
  * @arg int n
  *   Number of observations in the first sample
@@ -1,4 +1,5 @@
 #include <core/structs.h>
+#include <annotate/metric.h>
 
 /*
  * parse_command_line
@@ -31,3 +32,48 @@ int parse_command_line_d(int argc, char** argv, char** error_message, args_d_str
  * @return -1 if an error occurred. 0 otherwise.
  */
 int parse_filter_output_parameters(char* option, char** error_message, args_d_struct* arguments);
+
+/*
+ * parse_metric_parameters_d
+ *   Parses the string defining the distance metric between profiles
+ *
+ * @arg char* option
+ *   String defining the distance metric
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_d_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_metric_parameters_d(char* option, char** error_message, args_d_struct* arguments);
+
+/*
+ * parse_threads_parameters_d
+ *   Parses the string defining the number of worker threads
+ *
+ * @arg char* option
+ *   String defining the number of threads
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_d_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_threads_parameters_d(char* option, char** error_message, args_d_struct* arguments);
+
+/*
+ * parse_distances_parameters
+ *   Parses the string defining the distance files of both conditions
+ *
+ * @arg char* option
+ *   String defining the distance files
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_d_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_distances_parameters(char* option, char** error_message, args_d_struct* arguments);
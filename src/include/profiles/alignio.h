@@ -40,7 +40,8 @@ int parse_alignment(const args_p_struct *arguments, const alignment_struct *alig
 
 /*
  * next_tmprofile
- *   Read and process stored alignment in the alignment temporal file and store data in a profile handler struct
+ *   Read and process stored alignment in the alignment temporal file and store data in a profile handler struct.
+ *   It is reentrant, so the temporal files of several samples can be read by several threads at once.
  *
  * @arg FILE* fp
  *   Pointer to a profile temporal file
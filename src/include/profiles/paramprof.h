@@ -91,3 +91,52 @@ int parse_profiles_parameters(char* option, char** error_message, args_p_struct*
  * @return -1 if an error occurred. 0 otherwise.
  */
 int parse_trimming_parameters(char* option, char** error_message, args_p_struct* arguments);
+
+/*
+ * parse_workers_parameters
+ *   Parses the string defining the number of threads of batch mode
+ *
+ * @arg char* option
+ *   String defining the number of threads
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_p_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_workers_parameters(char* option, char** error_message, args_p_struct* arguments);
+
+/*
+ * parse_memory_parameters
+ *   Parses the string defining the memory budget of batch mode, in megabytes
+ *
+ * @arg char* option
+ *   String defining the memory budget
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_p_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_memory_parameters(char* option, char** error_message, args_p_struct* arguments);
+
+/*
+ * parse_sample_sheet
+ *   Reads the samples of the sample sheet of batch mode. Every line is a sample: the output folder followed by
+ *   the replicate BAM files, separated by tabs. Empty lines and lines starting with # are skipped.
+ *   Every sample takes the rest of the options from the command line.
+ *
+ * @arg char** error_message
+ *   Pointer to a char array where to store the error message
+ * @args args_p_struct* arguments
+ *   Pointer to the argument handler of the command line
+ * @arg args_p_struct** samples
+ *   Pointer where the newly allocated array of argument handlers of the samples is stored
+ * @arg int* nsamples
+ *   Pointer where the number of samples is stored
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_sample_sheet(char** error_message, args_p_struct* arguments, args_p_struct** samples, int* nsamples);
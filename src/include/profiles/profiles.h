@@ -4,8 +4,65 @@
 #include <profiles/idr.h>
 #include <profiles/trimming.h>
 #include <annotate/iofile.h>
+#include <core/parallel.h>
 
 /*
  * Application entry point
  */
 int profiles_sc(int argc, char** argv);
+
+/*
+ * profiles_defaults
+ *   Sets the default values of the profiles options
+ *
+ * @arg args_p_struct* arguments
+ *   Pointer to the argument handler
+ */
+void profiles_defaults(args_p_struct* arguments);
+
+/*
+ * Function called by profiles_build with the memory in bytes of the data kept per contig,
+ * once the contigs of the sample are counted and before that data is allocated
+ */
+typedef void (*profiles_reserve)(long bytes, void* data);
+
+/*
+ * profiles_build
+ *   Builds the profiles of the replicate BAM files and writes the profiles and contigs files to the output folder.
+ *   Errors are reported to the standard error.
+ *
+ * @arg args_p_struct* arguments
+ *   Pointer to the argument handler
+ * @arg profile_list_struct* list
+ *   Empty list where the profiles are also kept in memory, ready to be annotated, in the order of the
+ *   profiles file. NULL if profiles are only written to the file.
+ * @arg profiles_reserve reserve
+ *   Function called with the memory of the data kept per contig. NULL if memory is not accounted.
+ * @arg void* data
+ *   Data passed to the reserve function
+ *
+ * @return
+ *   0 if success. 1 otherwise.
+ */
+int profiles_build(args_p_struct* arguments, profile_list_struct* list, profiles_reserve reserve, void* data);
+
+/*
+ * profiles_batch
+ *   Builds the profiles of a batch of samples with a pool of threads. Samples are started in the order of the
+ *   sample sheet as long as the estimated memory of the samples being processed fits in the memory budget.
+ *   The memory of the contigs of a sample is added to the estimate once they are counted.
+ *   Errors are reported to the standard error and do not stop the rest of the samples.
+ *
+ * @arg args_p_struct* samples
+ *   Argument handlers of the samples, each one with its replicates and output folder
+ * @arg int nsamples
+ *   Number of samples
+ * @arg int threads
+ *   Number of worker threads
+ * @arg long memory
+ *   Memory budget in bytes
+ *
+ * @return
+ *   The number of samples that failed
+ */
+int profiles_batch(args_p_struct* samples, int nsamples, int threads, long memory);
@@ -0,0 +1,20 @@
+#include <core/structs.h>
+#include <profiles/paramprof.h>
+#include <annotate/paramclust.h>
+
+/*
+ * parse_command_line_r
+ *   Parses the command line. Profiles and annotate options are parsed by their own parsers.
+ *
+ * @arg int argc
+ *   Number of arguments in the command line
+ * @arg char** argv
+ *   Array containing the command line arguments
+ * @arg error_message
+ *   Pointer to a char array where to store the error message
+ * @arg args_r_struct* arguments
+ *   Pointer to the argument handler
+ *
+ * @return -1 if an error occurred. 0 otherwise.
+ */
+int parse_command_line_r(int argc, char** argv, char** error_message, args_r_struct* arguments);
@@ -0,0 +1,8 @@
+#include <run/paramrun.h>
+#include <profiles/profiles.h>
+#include <annotate/annotate.h>
+
+/*
+ * Application entry point
+ */
+int run_sc(int argc, char** argv);
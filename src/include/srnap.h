@@ -1,9 +1,11 @@
 #include <profiles/profiles.h>
 #include <annotate/annotate.h>
 #include <diffproc/diffproc.h>
+#include <run/run.h>
 
 
 // Subcommand identifiers
 #define PROFILES_SUBCOMMAND "profiles"
 #define ANNOTATE_SUBCOMMAND "annotate"
 #define DIFFPROC_SUBCOMMAND "diffproc"
+#define RUN_SUBCOMMAND "run"
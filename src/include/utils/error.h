@@ -17,6 +17,10 @@
  * ERROR : diffproc - bad syntax
  */
 #define ERR_DIFFPROC_HELP_MSG "Please type <srnap diffproc -h> for help"
+/*
+ * ERROR : run - bad syntax
+ */
+#define ERR_RUN_HELP_MSG "Please type <srnap run -h> for help"
 
 /*
  * ERROR : BED Format
@@ -42,6 +46,11 @@
  */
 #define ERR_INVALID_NUMBER_REPLICATES "Invalid number of arguments. Only up to 10 replicates allowed"
 
+/*
+ * ERROR : Invalid memory budget
+ */
+#define ERR_INVALID_m_VALUE "Memory budget <memory> must be an integer number of megabytes greater than 0"
+
 /*
  * ERROR : Invalid option for -f value
  */
@@ -123,6 +132,31 @@
  */
 #define ERR_INVALID_d_VALUE "Invalid argument for option -d"
 
+/*
+ * ERROR : Pruning with a metric that does not support it
+ */
+#define ERR_PRUNE_METRIC "Pruning distance can only be given for the xdtw metric"
+
+/*
+ * ERROR : Invalid argument for -k option
+ */
+#define ERR_INVALID_k_VALUE "Invalid argument for option -k"
+
+/*
+ * ERROR : Sparse distance graph with hierarchical clustering
+ */
+#define ERR_SPARSE_HC "Sparse distance graph (-s) cannot be used with hierarchical clustering (-c hc), which needs all the distances"
+
+/*
+ * ERROR : Invalid sparse graph radius
+ */
+#define ERR_INVALID_s_VALUE "Sparse graph radius <radius> must be a number greater than 0 and lower or equal than 1"
+
+/*
+ * ERROR : Invalid number of threads
+ */
+#define ERR_INVALID_j_VALUE "Number of threads <threads> must be an integer number greater than 0"
+
 /*
  * ERROR : Invalid argument for -o option
  */
@@ -182,6 +216,10 @@
  * ERROR : Cannot write in output file
  */
 #define ERR_OUTPUT_F_NOT_WRITABLE "Output path is not valid or output file is not writable"
+/*
+ * ERROR : Memory allocation failed
+ */
+#define ERR_NOT_ENOUGH_MEMORY "Not enough memory"
 /*
  * ERROR : Cannot re-allocate memory
  */
@@ -202,5 +240,31 @@
  * ERROR : Cannot read clusters file
  */
 #define ERR_CLUSTER_F_NOT_READABLE "Clusters file does not exist or is not readable"
+/*
+ * ERROR : Distance file does not match the profiles
+ */
+#define ERR_DISTANCES_F_NOT_MATCHING "Distance file is ill-formatted or does not match the profiles"
+
+/*
+ * ERROR : Distance file with intra-cluster distances that were not measured
+ */
+#define ERR_DISTANCES_F_NOT_MEASURED "Distance file has intra-cluster distances that were not measured (pruned or abandoned by annotate)"
+
+/*
+ * ERROR : Distance file calculated with another metric
+ */
+#define ERR_DISTANCES_F_METRIC "Distance file has no header or was not calculated with the metric given by -d"
+/*
+ * ERROR : Cannot read sample sheet
+ */
+#define ERR_SAMPLE_F_NOT_READABLE "Sample sheet does not exist, is not readable or is ill-formatted"
+/*
+ * ERROR : Two samples of the sample sheet write to the same folder
+ */
+#define ERR_SAMPLE_DUPLICATED_OUTPUT "Sample sheet has more than one sample with the same output folder"
+/*
+ * ERROR : No profiles to annotate
+ */
+#define ERR_NO_PROFILES "No profiles were built with the given options"
 
 #endif
@@ -6,14 +6,16 @@ The srnap subcommands include:\n\n\
 [ Profiling tools ]\n\
    profiles    ncRNA discovery and profiling from small RNA-Seq data\n\
    annotate    ncRNA clustering, classification and annotation from profile data\n\
-   diffproc    ncRNA differential processing from profile and clustering data between two conditions\n\n\
+   diffproc    ncRNA differential processing from profile and clustering data between two conditions\n\
+   run         ncRNA profiling, clustering and annotation from small RNA-Seq data in one step\n\n\
 [ General help ]\n\
    -h          Print this help menu\n\
    -v          What version of srnap are you using?"
 
 #define PROFILES_HELP_MSG "Tool      : profiles\n\n\
 Summary   : ncRNA discovery and profiling from small RNA-Seq data\n\n\
-Usage     : srnap profiles [OPTIONS] replicate_1.bam ... replicate_n.bam output_folder\n\n\
+Usage     : srnap profiles [OPTIONS] replicate_1.bam ... replicate_n.bam output_folder\n\
+            srnap profiles [OPTIONS] -b sample_sheet.txt\n\n\
 Options   :\n\
            -f   Read filtering\n\
                 Format is <minreadlen>, where:\n\
@@ -48,11 +50,29 @@ Options   :\n\
                   - <spacing> is the maximum distance between profiles. Profiles separated by <spacing> or less bp are merged into one single profile. Must be >= 0.\n\
                   - <minheight> is the minimum number of piled-up reads. Profiles that have less than <minheight> piled-up reads are not reported. Must be > 0.\n\
                 [ Default is 16:200:20:50 ]\n\n\
+           -b   Batch mode\n\
+                Format is <sample_sheet>, where:\n\
+                  - <sample_sheet> is a file with one sample per line: the output folder of the sample followed by its replicate BAM files,\n\
+                                   separated by tabs. Empty lines and lines starting with # are skipped.\n\
+                All the samples are processed with the same options. Output folders must be different.\n\
+                [ Default is disabled ]\n\n\
+           -j   Number of threads for batch mode\n\
+                Format is <threads>, where:\n\
+                  - <threads> is the number of samples processed at once. Must be > 0.\n\
+                [ Default is 1 ]\n\n\
+           -m   Memory budget for batch mode\n\
+                Format is <memory>, where:\n\
+                  - <memory> is the memory in megabytes available to the samples processed at once. Must be > 0.\n\
+                Samples are started in the order of the sample sheet while their estimated memory fits in the budget.\n\
+                The estimate covers the block of alignments read at once. The data kept per contig is added to it once the\n\
+                contigs of a sample are counted, and holds back the next samples until it is released.\n\
+                [ Default is the physical memory ]\n\n\
 Output :\n\
            output_folder/profiles.dat : List of ncRNA profiles with per-base heights\n\
            output_folder/contigs.dat  : List of unfiltered contigs\n\n\
 Examples :\n\
-           srnap profiles -f 20 -i sere:2 -r pool -t 0.1:5:20 -p 20:200:39:100 replicate1.bam replicate2.bam output_dir"
+           srnap profiles -f 20 -i sere:2 -r pool -t 0.1:5:20 -p 20:200:39:100 replicate1.bam replicate2.bam output_dir\n\
+           srnap profiles -i sere:2 -b samples.txt -j 8 -m 16000"
 
 #define ANNOTATE_HELP_MSG "Tool      : annotate\n\n\
 Summary   : ncRNA clustering, classification and annotation from profile data\n\n\
@@ -69,15 +89,70 @@ Options   :\n\
                  [ Default is 0.9:0.5 ]\n\n\
             -x   Distance file\n\
                  Format is <distance_file>, where:\n\
-                   - <distance_file> is the file with pairwise distances between profiles\n\
+                   - <distance_file> is the file with pairwise distances between profiles, as the crosscor.dat file computed by annotate\n\
                  When -x option is specified, distances are not calculated and directly taken from the provided file\n\
                  [ No default value ]\n\n\
+            -j   Number of threads\n\
+                 Format is <threads>, where:\n\
+                   - <threads> is the number of worker threads used for clustering. Must be > 0.\n\
+                 [ Default is 1 ]\n\n\
+            -p   Pruning distance\n\
+                 Format is <distance>, where:\n\
+                   - <distance> is a number between 0 and 1\n\
+                 Pairs of profiles whose xdtw distance is proven to be above <distance> by a lower bound are not aligned.\n\
+                 Their distance is set to 1 and written to the distance file as ><distance>, meaning that it was not measured.\n\
+                 Pruning is exact: pairs at a distance <= <distance> are always aligned. Only for the xdtw metric.\n\
+                 [ Default is 1 (no pruning) ]\n\n\
+            -s   Sparse distance graph\n\
+                 Format is <radius>, where:\n\
+                   - <radius> is a number greater than 0 and lower or equal than 1\n\
+                 Only distances <= <radius> are kept in memory and the rest are taken as 1\n\
+                 Alignments of pairs that cannot be closer than <radius> are abandoned and written to the distance file as ><radius>\n\
+                 Not available with -c hc, as hierarchical clustering needs all the distances\n\
+                 [ No default value. All the distances are kept ]\n\n\
+            -d   Distance metric\n\
+                 Format is <metric>, where:\n\
+                   - <metric> is one of xdtw, nxcorr, adtw, dtw, euclid, pearson, spearman or kendall\n\
+                 xdtw, nxcorr, adtw and dtw align the whole profiles. euclid, pearson, spearman and kendall\n\
+                 compare the profiles resampled to 64 segments of equal width\n\
+                 [ Default is xdtw ]\n\n\
+            -w   Sort-and-sweep annotation\n\
+                 Features of all the annotation files are loaded at once, sorted with the profiles by chromosome, strand and start,\n\
+                 and swept once per chromosome and strand. Chromosomes are swept in parallel with the threads given by -j.\n\
+                 Annotations are the same as without -w\n\
+                 Without -w, annotation files are read in chunks of 4 MB, one per thread at a time, and every chunk is annotated\n\
+                 as soon as it is read, so only the chunks being read are kept in memory\n\
+                 [ Default is disabled ]\n\n\
+            -c   Clustering method\n\
+                 Format is <method[:parameters]>, where:\n\
+                   - <method> is dpclust (density-peak clustering) or hc (complete-linkage hierarchical clustering)\n\
+                   - <parameters> is, for hc, <cutoff>, the distance at which the hierarchical tree is branched\n\
+                   - <parameters> is, for dpclust, <increment[:truncation]>, where:\n\
+                       - <increment> is the increment of the impact factor scanned to find the distance cutoff (dc). Must be >= 0.000001.\n\
+                       - <truncation> is the multiple of dc beyond which points do not add to the gaussian densities. 0 to add all the points.\n\
+                 When no cutoff is given for hc, the cutoff with the best V-measure for the annotation is used and -a is required\n\
+                 The dc of dpclust is bracketed on binned distances and refined on the exact distances over the grid of increments of <parameter>.\n\
+                 With the default increment, clusters are the same as with the exhaustive scan of the grid unless the entropy of the potentials\n\
+                 has another minimum farther from the binned one, in which case the nearest minimum is taken and clusters may differ\n\
+                 [ Default is dpclust:0.005:0 ]\n\n\
 Output    :\n\
             output_folder/crosscorr.dat    : List of distances between pairs of profiles (only if no distance file is provided)\n\
-            output_folder/annotation.bed   : List of annotated features in BED file (only if annotation file is provided)\n\n\
+                                             A first line #metric<tab>pruning<tab>sparse records how distances were calculated\n\
+                                             Distances are written with full precision\n\
+                                             Distances that were not measured (-p, -s) are written as >d, d being the distance they are above\n\
+            output_folder/annotation.bed   : List of annotated features in BED file (only if annotation file is provided)\n\
+            output_folder/clusters.neWick  : Hierarchical clustering tree in neWick format (only with -c hc)\n\
+            output_folder/vmeasure.dat     : Cutoff, number of clusters, homogeneity, completeness and V-measure of every cutoff tried (only with -c hc and no cutoff)\n\n\
 Examples  :\n\
             srnap annotate -a hsap_micrornas.bed profiles.dat output_dir\n\
-            srnap annotate -a hsap_micrornas.bed -x crosscor.dat profiles.dat output_dir"
+            srnap annotate -a hsap_micrornas.bed -x crosscor.dat profiles.dat output_dir\n\
+            srnap annotate -a hsap_micrornas.bed -j 8 profiles.dat output_dir\n\
+            srnap annotate -a hsap_micrornas.bed -p 0.5 profiles.dat output_dir\n\
+            srnap annotate -a hsap_micrornas.bed -p 0.5 -s 0.5 profiles.dat output_dir\n\
+            srnap annotate -a hsap_micrornas.bed -d nxcorr profiles.dat output_dir\n\
+            srnap annotate -a gencode.bed -w -j 8 profiles.dat output_dir\n\
+            srnap annotate -a hsap_micrornas.bed -c hc -j 8 profiles.dat output_dir\n\
+            srnap annotate -c hc:0.3 profiles.dat output_dir"
 
 #define DIFFPROC_HELP_MSG "Tool      : diffproc\n\n\
 Summary   : ncRNA differential processing from profile and clustering data between two conditions\n\n\
@@ -88,10 +163,57 @@ Options   :\n\
                    - <pvalue> is the p-value threshold for filtering differentially processed profiles\n\
                    - <foldchange> is the distance fold-change threshold for filtering differentially processed clusters\n\
                  [ Default is 0.01:0.5 ]\n\n\
+            -d   Distance metric\n\
+                 Format is <metric>, where:\n\
+                   - <metric> is one of xdtw, nxcorr, adtw, dtw, euclid, pearson, spearman or kendall\n\
+                 xdtw, nxcorr, adtw and dtw align the whole profiles. euclid, pearson, spearman and kendall\n\
+                 compare the profiles resampled to 64 segments of equal width\n\
+                 [ Default is xdtw ]\n\n\
+            -j   Number of threads\n\
+                 Format is <threads>, where:\n\
+                   - <threads> is the number of worker threads used for distance calculations. Must be > 0.\n\
+                 [ Default is 1 ]\n\n\
+            -x   Distance files\n\
+                 Format is <distance_file_1:distance_file_2>, where:\n\
+                   - <distance_file_1> is the crosscor.dat file computed by annotate for profile_file_1.dat\n\
+                   - <distance_file_2> is the crosscor.dat file computed by annotate for profile_file_2.dat\n\
+                 When -x option is specified, intra-cluster distances are not calculated and directly taken from the provided files\n\
+                 Files must have been computed with the metric given by -d, which annotate records in their header line.\n\
+                 Files with intra-cluster distances that were not measured (pruned or abandoned with -p or -s) are refused\n\
+                 [ No default value ]\n\n\
+            -s   Streaming mode\n\
+                 Clusters of profile_file_1.dat are assessed one at a time. Only the profiles of the cluster and of the clusters\n\
+                 of profile_file_2.dat where their partners are are kept in memory.\n\
+                 [ Default is disabled ]\n\n\
 Output    :\n\
             output_folder/diffprofiles.dat : List of differentially processed profiles\n\
             output_folder/diffclusters.dat : List of differentially processed clusters\n\n\
 Examples  :\n\
             srnap diffproc wild_type/profiles.dat wild_type/annotation.bed treated/profiles.dat treated/annotation.bed output_dir\n\
-            srnap diffproc -g 0.01:0.2 wild_type/profiles.dat wild_type/annotation.bed treated/profiles.dat treated/annotation.bed output_dir"
+            srnap diffproc -g 0.01:0.2 wild_type/profiles.dat wild_type/annotation.bed treated/profiles.dat treated/annotation.bed output_dir\n\
+            srnap diffproc -j 8 wild_type/profiles.dat wild_type/annotation.bed treated/profiles.dat treated/annotation.bed output_dir\n\
+            srnap diffproc -x wild_type/crosscor.dat:treated/crosscor.dat wild_type/profiles.dat wild_type/annotation.bed treated/profiles.dat treated/annotation.bed output_dir\n\
+            srnap diffproc -s wild_type/profiles.dat wild_type/annotation.bed treated/profiles.dat treated/annotation.bed output_dir"
+#define RUN_HELP_MSG "Tool      : run\n\n\
+Summary   : ncRNA profiling, clustering and annotation from small RNA-Seq data in one step\n\n\
+Usage     : srnap run [OPTIONS] replicate_1.bam ... replicate_n.bam output_folder\n\n\
+            Profiles are built as with srnap profiles and annotated as with srnap annotate in the same process.\n\
+            Profiles are passed to annotate in memory, without reading the profiles file.\n\n\
+Options   :\n\
+            -f, -i, -r, -t, -p   Profiles options. See <srnap profiles -h>\n\n\
+            -a, -o, -j, -s, -d, -w, -c   Annotate options. See <srnap annotate -h>\n\n\
+            -k   Pruning distance\n\
+                 Same as the -p option of srnap annotate\n\
+                 [ Default is 1 (no pruning) ]\n\n\
+Output    :\n\
+            output_folder/profiles.dat     : List of ncRNA profiles with per-base heights\n\
+            output_folder/contigs.dat      : List of unfiltered contigs\n\
+            output_folder/crosscorr.dat    : List of distances between pairs of profiles\n\
+            output_folder/annotation.bed   : List of annotated features in BED file\n\
+            output_folder/clusters.neWick  : Hierarchical clustering tree in neWick format (only with -c hc)\n\
+            output_folder/vmeasure.dat     : Cutoff, number of clusters, homogeneity, completeness and V-measure of every cutoff tried (only with -c hc and no cutoff)\n\n\
+Examples  :\n\
+            srnap run -a hsap_micrornas.bed replicate1.bam replicate2.bam output_dir\n\
+            srnap run -i sere:2 -p 20:200:39:100 -a hsap_micrornas.bed -k 0.5 -j 8 replicate1.bam replicate2.bam output_dir"
+
 #endif
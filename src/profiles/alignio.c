@@ -51,6 +51,7 @@ int next_alignment(samfile_t *bam_file, alignment_struct *alignment, int replica
       alignment->replicate = replica;
       alignment->nreads = 1;
       strncpy(alignment->chromosome, chr, MAX_FEATURE);
+      alignment->tid = bam_alignment->core.tid;
       alignment->start = pos;
       alignment->end = end;
       if (flag & BAM_FREVERSE)
@@ -79,6 +80,7 @@ int parse_alignment(const args_p_struct *arguments, const alignment_struct *alig
     primary->start = alignment->start;
     primary->end = alignment->end;
     strncpy(primary->chromosome, alignment->chromosome, MAX_FEATURE);
+    primary->tid = alignment->tid;
     primary->profile = (double*) malloc(sizeof(double) * (primary->end - primary->start + 1));
     primary->nreads = (int*) malloc(sizeof(int) * (arguments->number_replicates));
     int i;
@@ -96,7 +98,7 @@ int parse_alignment(const args_p_struct *arguments, const alignment_struct *alig
     //                         chr A  |----------|
     //                         chr A      |------------|
     //                         chr A  |----------------|
-    if (strcmp(alignment->chromosome, primary->chromosome) == 0 && alignment->end <= primary->end && alignment->end > primary->start) {
+    if (alignment->tid == primary->tid && alignment->end <= primary->end && alignment->end > primary->start) {
       int i;
       if ((arguments->replicate_treat != REPLICATE_REPLICATE) || ((arguments->replicate_treat == REPLICATE_REPLICATE) && ((arguments->replicate_number - 1) == alignment->replicate)))
         for (i = alignment->start - primary->start; i < (alignment->end - primary->start + 1); i++) primary->profile[i] += alignment->nreads;
@@ -110,7 +112,7 @@ int parse_alignment(const args_p_struct *arguments, const alignment_struct *alig
     //                         chr A  |---------------------|
     //                         chr A                   |----|
     //                         chr A                    spacing |-------|
-    else if (strcmp(alignment->chromosome, primary->chromosome) == 0 && alignment->start <= (primary->end + arguments->spacing + 1) && alignment->end > primary->start) {
+    else if (alignment->tid == primary->tid && alignment->start <= (primary->end + arguments->spacing + 1) && alignment->end > primary->start) {
       double *profile_realloc = (double*) realloc(primary->profile, sizeof(double) * (alignment->end - primary->start + 1));
       if (profile_realloc == NULL) {
         free(primary->profile);
@@ -164,6 +166,7 @@ int parse_alignment(const args_p_struct *arguments, const alignment_struct *alig
       primary->start = alignment->start;
       primary->end = alignment->end;
       strncpy(primary->chromosome, alignment->chromosome, MAX_FEATURE);
+      primary->tid = alignment->tid;
       double *profile_realloc = (double*) realloc(primary->profile, sizeof(double) * (primary->end - primary->start + 1));
       if (profile_realloc == NULL) {
         free(primary->profile);
@@ -188,7 +191,7 @@ int parse_alignment(const args_p_struct *arguments, const alignment_struct *alig
 int next_tmprofile(FILE* fp, profile_struct* profile)
 {
   char *line = NULL;
-  char *token;
+  char *token, *saveptr;
   size_t len = 0;
   ssize_t read;
   int i, nreads, length;
@@ -203,19 +206,19 @@ int next_tmprofile(FILE* fp, profile_struct* profile)
     return(0);
   }
 
-  if ((token = strtok(line, "\t")) == NULL) {
+  if ((token = strtok_r(line, "\t", &saveptr)) == NULL) {
     free(line);
     return(-1);
   }
   strcpy(profile->chromosome, token);
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL) {
     free(line);
     return(-1);
   }
   profile->start = atoi(token);
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL) {
     free(line);
     return(-1);
   }
@@ -223,13 +226,13 @@ int next_tmprofile(FILE* fp, profile_struct* profile)
   profile->length = profile->end - profile->start + 1;
   profile->olength = profile->length;
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL) {
     free(line);
     return(-1);
   }
   profile->strand = atoi(token);
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL) {
     free(line);
     return(-1);
   }
@@ -237,7 +240,7 @@ int next_tmprofile(FILE* fp, profile_struct* profile)
 
   profile->nreads = (int*) malloc(nreads * sizeof(int));
   for (i = 0; i < nreads; i++) {
-    if ((token = strtok(NULL, "\t")) != NULL)
+    if ((token = strtok_r(NULL, "\t", &saveptr)) != NULL)
       profile->nreads[i] = atoi(token);
     else {
       free(line);
@@ -245,7 +248,7 @@ int next_tmprofile(FILE* fp, profile_struct* profile)
     }
   }
 
-  if ((token = strtok(NULL, "\t")) == NULL) {
+  if ((token = strtok_r(NULL, "\t", &saveptr)) == NULL) {
     free(line);
     return(-1);
   }
@@ -260,7 +263,7 @@ int next_tmprofile(FILE* fp, profile_struct* profile)
   profile->profile = (double*) malloc((profile->end - profile->start + 1) * sizeof(double));
   profile->free = 1;
   for (i = 0; i < (profile->end - profile->start + 1); i++) {
-    if ((token = strtok(NULL, "\t")) != NULL)
+    if ((token = strtok_r(NULL, "\t", &saveptr)) != NULL)
       profile->profile[i] = (double) atof(token);
     else {
       free(line);
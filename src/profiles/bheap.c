@@ -21,6 +21,8 @@ void destroybh(heap_struct* bh)
 {
   free(bh->heap);
   free(bh->alignments);
+  bh->heap = NULL;
+  bh->alignments = NULL;
 }
 
 /*
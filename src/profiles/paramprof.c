@@ -11,7 +11,7 @@ int parse_command_line_p(int argc, char** argv, char** error_message, args_p_str
   char carg;
   int terminate = 0;
 
-  while(((carg = getopt(argc, argv, "hvf:p:r:i:t:")) != -1) && (terminate >= 0)) {
+  while(((carg = getopt(argc, argv, "hvf:p:r:i:t:b:j:m:")) != -1) && (terminate >= 0)) {
     switch (carg) {
       case 'h':
         terminate--;
@@ -36,11 +36,30 @@ int parse_command_line_p(int argc, char** argv, char** error_message, args_p_str
       case 't':
         terminate = parse_trimming_parameters(optarg, error_message, arguments);
         break;
+      case 'b':
+        arguments->batch = 1;
+        strncpy(arguments->batch_f_path, optarg, MAX_PATH);
+        break;
+      case 'j':
+        terminate = parse_workers_parameters(optarg, error_message, arguments);
+        break;
+      case 'm':
+        terminate = parse_memory_parameters(optarg, error_message, arguments);
+        break;
       case '?':
         terminate--;
         *error_message = ERR_INVALID_ARGUMENT;
     }
   }
+  // Replicates and output folders of the samples are given by the sample sheet in batch mode
+  if (!terminate && arguments->batch) {
+    if (argc != optind) {
+      terminate--;
+      *error_message = ERR_INVALID_NUMBER_ARGUMENTS;
+    }
+    return(terminate);
+  }
+
   if (!terminate && (argc - optind) < 2) {
     terminate--;
     *error_message = ERR_INVALID_NUMBER_ARGUMENTS;
@@ -314,3 +333,129 @@ int parse_trimming_parameters(char* option, char** error_message, args_p_struct*
 
   return(0);
 }
+
+
+/*
+ * parse_workers_parameters
+ *
+ * @see include/profiles/paramprof.h
+ */
+int parse_workers_parameters(char* option, char** error_message, args_p_struct* arguments)
+{
+  arguments->threads = atoi(option);
+  if (arguments->threads < 1) {
+    *error_message = ERR_INVALID_j_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_memory_parameters
+ *
+ * @see include/profiles/paramprof.h
+ */
+int parse_memory_parameters(char* option, char** error_message, args_p_struct* arguments)
+{
+  arguments->memory = atol(option);
+  if (arguments->memory < 1) {
+    *error_message = ERR_INVALID_m_VALUE;
+    return(-1);
+  }
+
+  return(0);
+}
+
+
+/*
+ * parse_sample_sheet
+ *
+ * @see include/profiles/paramprof.h
+ */
+int parse_sample_sheet(char** error_message, args_p_struct* arguments, args_p_struct** samples, int* nsamples)
+{
+  FILE* fp;
+  char *line = NULL, *token, *saveptr;
+  size_t len = 0;
+  int i, capacity = 0, failed = 0;
+
+  *samples = NULL;
+  *nsamples = 0;
+  if ((fp = fopen(arguments->batch_f_path, "r")) == NULL) {
+    *error_message = ERR_SAMPLE_F_NOT_READABLE;
+    return(-1);
+  }
+
+  // Every sample starts with the options of the command line
+  while (getline(&line, &len, fp) >= 0) {
+    args_p_struct* sample;
+
+    line[strcspn(line, "\r\n")] = '\0';
+    if ((line[0] == '\0') || (line[0] == '#'))
+      continue;
+
+    if (*nsamples == capacity) {
+      args_p_struct* resized;
+      capacity = (capacity > 0) ? 2 * capacity : SAMPLE_SHEET_CAPACITY;
+      if ((resized = (args_p_struct*) realloc(*samples, capacity * sizeof(args_p_struct))) == NULL) {
+        *error_message = ERR_NOT_ENOUGH_MEMORY;
+        failed = 1;
+        break;
+      }
+      *samples = resized;
+    }
+    sample = &(*samples)[*nsamples];
+    *sample = *arguments;
+    sample->batch = 0;
+    sample->number_replicates = 0;
+
+    if ((token = strtok_r(line, "\t", &saveptr)) == NULL) {
+      *error_message = ERR_SAMPLE_F_NOT_READABLE;
+      failed = 1;
+      break;
+    }
+    strncpy(sample->output_f_path, token, MAX_PATH);
+
+    // Samples would overwrite each other's outputs. Trailing separators do not name another folder.
+    for (i = strlen(sample->output_f_path) - 1; (i > 0) && (sample->output_f_path[i] == PATH_SEPARATOR[0]); i--)
+      sample->output_f_path[i] = '\0';
+    for (i = 0; (i < *nsamples) && (strcmp((*samples)[i].output_f_path, sample->output_f_path) != 0); i++);
+    if (i < *nsamples) {
+      *error_message = ERR_SAMPLE_DUPLICATED_OUTPUT;
+      failed = 1;
+      break;
+    }
+    while (((token = strtok_r(NULL, "\t", &saveptr)) != NULL) && (sample->number_replicates < MAX_REPLICATES))
+      strncpy(sample->replicate_f_path[sample->number_replicates++], token, MAX_PATH);
+
+    if ((token != NULL) || (sample->number_replicates == 0)) {
+      *error_message = (token != NULL) ? ERR_INVALID_NUMBER_REPLICATES : ERR_SAMPLE_F_NOT_READABLE;
+      failed = 1;
+      break;
+    }
+    if ((sample->replicate_treat == REPLICATE_REPLICATE) && (sample->replicate_number > sample->number_replicates)) {
+      *error_message = ERR_INVALID_repnumber_VALUE;
+      failed = 1;
+      break;
+    }
+    (*nsamples)++;
+  }
+
+  // Lines are parsed until the first error. Sheets without samples are ill-formatted.
+  free(line);
+  fclose(fp);
+  if (!failed && (*nsamples == 0)) {
+    *error_message = ERR_SAMPLE_F_NOT_READABLE;
+    failed = 1;
+  }
+  if (failed) {
+    free(*samples);
+    *samples = NULL;
+    *nsamples = 0;
+    return(-1);
+  }
+
+  return(0);
+}
@@ -36,6 +36,7 @@ int compare_double (const void *a, const void *b)
 void deepcpy(alignment_struct* destiny, alignment_struct* source)
 {
   strncpy(destiny->chromosome, source->chromosome, MAX_FEATURE);
+  destiny->tid = source->tid;
   destiny->start = source->start;
   destiny->end = source->end;
   destiny->strand = source->strand;
@@ -72,20 +73,20 @@ int morcgez(const int operators[], const int pos)
 
 
 /*
- * nmstrcmp
- *   Negative Multiple STRCMP
+ * nmtidcmp
+ *   Negative Multiple chromosome comparison
  *
  * @args alignment_struct operators[]
- *   Each chromosome field in the array will be strcmp
+ *   The chromosome identifier of each alignment in the array will be compared
  * @args pos
  *   Number of positions to be compared
- * @args str
- *   String to be compared
+ * @args tid
+ *   Chromosome identifier (index in the BAM header) to be compared
  *
  * @return
- *   1 if all the positions are different than str. 0 otherwise.
+ *   1 if all the positions are different than tid. 0 otherwise.
  */
-int nmstrcmp(const alignment_struct operators[], const int pos, const char* str)
+int nmtidcmp(const alignment_struct operators[], const int pos, const int32_t tid)
 {
   int i, result = 1;
 
@@ -93,55 +94,83 @@ int nmstrcmp(const alignment_struct operators[], const int pos, const char* str)
     return 0;
 
   for (i = 0; i < pos; i++)
-    result = result && (strcmp(operators[i].chromosome, str) != 0);
+    result = result && (operators[i].tid != tid);
 
   return(result);
 }
 
 
+/*
+ * print_profile
+ *   Prints a profile to the profiles file. If list is not NULL, the profile is also appended to it,
+ *   with the heights read back from the printed text so that it is the profile annotate would load.
+ *
+ * @arg FILE* fp
+ *   Profiles file descriptor
+ * @arg profile_list_struct* list
+ *   List of profiles in memory, or NULL
+ * @arg char* chromosome
+ *   Chromosome of the profile
+ * @arg int start, end, strand
+ *   Location of the profile
+ * @arg double* heights
+ *   The end - start + 1 heights of the profile
+ *
+ * @return
+ *   0 if success. -1 if there is not enough memory.
+ */
+int print_profile(FILE* fp, profile_list_struct* list, char* chromosome, int start, int end, int strand, double* heights)
+{
+  profile_struct_annotation* p = NULL;
+  char height[MAX_FEATURE];
+  int i;
+
+  if (list != NULL) {
+    if (list->size == list->capacity) {
+      profile_struct_annotation* profiles;
+      list->capacity = (list->capacity > 0) ? 2 * list->capacity : PROFILE_LIST_CAPACITY;
+      profiles = (profile_struct_annotation*) realloc(list->profiles, list->capacity * sizeof(profile_struct_annotation));
+      if (profiles == NULL)
+        return(-1);
+      list->profiles = profiles;
+    }
+    p = &list->profiles[list->size];
+    if ((p->profile = (double*) malloc((end - start + 1) * sizeof(double))) == NULL)
+      return(-1);
+    strcpy(p->chromosome, chromosome);
+    p->start = start;
+    p->end = end;
+    p->length = end - start + 1;
+    p->strand = strand;
+    list->size++;
+  }
+
+  fprintf(fp, "%s:%d-%d:%s", chromosome, start, end, STR(strand));
+  for (i = 0; i < (end - start + 1); i++) {
+    snprintf(height, MAX_FEATURE, "%f", heights[i]);
+    fprintf(fp, "\t%s", height);
+    if (p != NULL)
+      p->profile[i] = atof(height);
+  }
+  fprintf(fp, "\n");
+
+  if (p != NULL)
+    prepare_profile(p);
+
+  return(0);
+}
+
+
 /*
  * Application entry point
  */
 int profiles_sc(int argc, char **argv)
 {
-  // Define and declare variables
   args_p_struct arguments;                             // Struct for handling command line parameters
-  FILE* tmprofiles_file;                               // Temporal output file descriptor
-  FILE* profiles_file;                                 // Profiles output file desciptor
-  FILE* contigs_file;                                  // Contigs output file descriptor
-  char* tmprofiles_file_name;                          // Absolute path of the temporal output file
-  char* profiles_file_name;                            // Absolute path of the profiles output file
-  char* contigs_file_name;                             // Absolute path of the contigs output file
-  samfile_t* replicate_file[MAX_REPLICATES];           // Array of BAM file descriptors
-  alignment_struct current_alignments[MAX_REPLICATES]; // Array of alignment_struct struct
-  int result;                                          // Result of any operation
-  int results[MAX_REPLICATES];                         // Replicate-specific results
   char* error_message;                                 // Error message to display in case of abnormal termination
-  contig_struct contig_fwd, contig_rev;                // Struct for building profiles
-  int i, j, index, chridx, blkidx, maxstart;           // Multi-purpose indexes and checkpoint variables
-  char curr_chrom[MAX_FEATURE];                        // Current chromosome
-  int curr_len;                                        // Current length
-  int ncontigs;                                        // Number of contigs
-  int** reads_per_contig;                              // Data matrix containing number of reads per contig and replicate
-  profile_struct profile;                              // Profile struct
-  sere_struct* sere_s;                                 // SERE fast calculation struct pointer
-  npidr_struct* npidr_s;                               // npIDR fast calculation struct pointer
 
   // Initialize options with default values
-  arguments.number_replicates = MAX_REPLICATES;
-  arguments.min_len = MIN_LEN;
-  arguments.max_len = MAX_LEN;
-  arguments.spacing = SPACING;
-  arguments.min_reads = MIN_READS;
-  arguments.replicate_treat = REPLICATE_POOL;
-  arguments.replicate_number = REPLICATE_NUMBER;
-  arguments.idr_method = IDR_COMMON;
-  arguments.idr_cutoff = CUTOFF;
-  arguments.read_length = MAX_READ_LENGTH;
-  arguments.min_read_len = MIN_READ_LEN;
-  arguments.trim_threshold = TRIM_THRESHOLD;
-  arguments.trim_min = TRIM_MIN;
-  arguments.trim_max = TRIM_MAX;
+  profiles_defaults(&arguments);
 
   // Parse command line
   // Exit if command is not well-formed
@@ -153,67 +182,343 @@ int profiles_sc(int argc, char **argv)
     return(1);
   }
 
+  // Build the profiles of every sample of the sample sheet in batch mode
+  if (arguments.batch) {
+    args_p_struct* samples;
+    int nsamples, failed;
+    long memory;
+
+    if (parse_sample_sheet(&error_message, &arguments, &samples, &nsamples) < 0) {
+      fprintf(stderr, "%s - %s\n", error_message, arguments.batch_f_path);
+      return(1);
+    }
+    memory = arguments.memory * 1024 * 1024;
+    if (memory == 0)
+      memory = sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    failed = profiles_batch(samples, nsamples, arguments.threads, memory);
+    free(samples);
+    return(failed > 0);
+  }
+
+  return(profiles_build(&arguments, NULL, NULL, NULL));
+}
+
+
+/*
+ * Struct for scheduling the samples of a batch
+ *   memory  : budget in bytes of the samples processed at once
+ *   used    : memory reserved by the samples being processed
+ *   running : number of samples being processed
+ */
+typedef struct {
+  args_p_struct* samples;
+  int* results;
+  long memory;
+  long used;
+  int running;
+  pthread_mutex_t lock;
+  pthread_cond_t released;
+} batch_struct;
+
+/*
+ * Struct for the memory reserved by a sample of a batch
+ *   bytes : memory reserved so far, released when the sample is done
+ */
+typedef struct {
+  batch_struct* batch;
+  long bytes;
+} reservation_struct;
+
+/*
+ * sample_memory
+ *   Memory of building the profiles of a sample that is known before its replicates are read:
+ *   the block of alignments read from them and the SERE totals per replicate.
+ */
+long sample_memory(args_p_struct* sample)
+{
+  long block, sere;
+
+  block = (long) MAX_BLOCK * sample->read_length * 2 * sample->number_replicates * sizeof(alignment_struct);
+  sere = sizeof(sere_struct) + sample->number_replicates * sizeof(long);
+
+  return(block + sere);
+}
+
+/*
+ * contig_memory
+ *   Memory of the data kept per contig of a sample: the reads per contig and replicate,
+ *   and the npIDR hash entries and results
+ */
+long contig_memory(int ncontigs, int nreplicates)
+{
+  long per_contig;
+
+  per_contig = sizeof(int*) + nreplicates * sizeof(int);
+  per_contig += sizeof(long) + nreplicates * (sizeof(struct llist_struct*) + sizeof(struct llist_struct));
+
+  return(ncontigs * per_contig);
+}
+
+/*
+ * batch_reserve
+ *   Adds the memory of the contigs of a sample to its reservation. The sample does not wait for it to fit,
+ *   as it already holds its alignment block, but no other sample is started until it does.
+ */
+void batch_reserve(long bytes, void* data)
+{
+  reservation_struct* reservation = (reservation_struct*) data;
+
+  pthread_mutex_lock(&reservation->batch->lock);
+  reservation->batch->used += bytes;
+  reservation->bytes += bytes;
+  pthread_mutex_unlock(&reservation->batch->lock);
+}
+
+/*
+ * batch_task
+ *   Builds the profiles of a sample once the memory known before reading its replicates fits in the budget.
+ *   A sample that does not fit even alone is processed when no other sample is.
+ */
+void batch_task(int index, int thread, void* data)
+{
+  batch_struct* batch = (batch_struct*) data;
+  args_p_struct* sample = &batch->samples[index];
+  reservation_struct reservation;
+
+  reservation.batch = batch;
+  reservation.bytes = sample_memory(sample);
+  pthread_mutex_lock(&batch->lock);
+  while ((batch->running > 0) && (batch->used + reservation.bytes > batch->memory))
+    pthread_cond_wait(&batch->released, &batch->lock);
+  batch->used += reservation.bytes;
+  batch->running++;
+  pthread_mutex_unlock(&batch->lock);
+
+  fprintf(stderr, "[LOG] SAMPLE %s\n", sample->output_f_path);
+  batch->results[index] = profiles_build(sample, NULL, batch_reserve, &reservation);
+
+  pthread_mutex_lock(&batch->lock);
+  batch->used -= reservation.bytes;
+  batch->running--;
+  pthread_cond_broadcast(&batch->released);
+  pthread_mutex_unlock(&batch->lock);
+}
+
+
+/*
+ * profiles_batch
+ *
+ * @see include/profiles/profiles.h
+ */
+int profiles_batch(args_p_struct* samples, int nsamples, int threads, long memory)
+{
+  batch_struct batch;
+  int i, failed;
+
+  batch.samples = samples;
+  batch.results = (int*) calloc(nsamples, sizeof(int));
+  batch.memory = memory;
+  batch.used = 0;
+  batch.running = 0;
+  if (batch.results == NULL) {
+    fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+    return(nsamples);
+  }
+  pthread_mutex_init(&batch.lock, NULL);
+  pthread_cond_init(&batch.released, NULL);
+
+  parallel_for(nsamples, threads, 1, batch_task, &batch);
+
+  failed = 0;
+  for (i = 0; i < nsamples; i++) {
+    if (batch.results[i] != 0) {
+      fprintf(stderr, "[LOG] SAMPLE %s FAILED\n", samples[i].output_f_path);
+      failed++;
+    }
+  }
+
+  pthread_mutex_destroy(&batch.lock);
+  pthread_cond_destroy(&batch.released);
+  free(batch.results);
+
+  return(failed);
+}
+
+
+/*
+ * profiles_defaults
+ *
+ * @see include/profiles/profiles.h
+ */
+void profiles_defaults(args_p_struct* arguments)
+{
+  arguments->number_replicates = MAX_REPLICATES;
+  arguments->min_len = MIN_LEN;
+  arguments->max_len = MAX_LEN;
+  arguments->spacing = SPACING;
+  arguments->min_reads = MIN_READS;
+  arguments->replicate_treat = REPLICATE_POOL;
+  arguments->replicate_number = REPLICATE_NUMBER;
+  arguments->idr_method = IDR_COMMON;
+  arguments->idr_cutoff = CUTOFF;
+  arguments->read_length = MAX_READ_LENGTH;
+  arguments->min_read_len = MIN_READ_LEN;
+  arguments->trim_threshold = TRIM_THRESHOLD;
+  arguments->trim_min = TRIM_MIN;
+  arguments->trim_max = TRIM_MAX;
+  arguments->batch = BATCH_CONDITION;
+  arguments->threads = THREADS;
+  arguments->memory = BATCH_MEMORY;
+}
+
+
+/*
+ * Struct for handling the files and buffers of a sample being built, so they can be released on failure
+ */
+typedef struct {
+  samfile_t* replicate_file[MAX_REPLICATES];
+  FILE* tmprofiles_file;
+  FILE* profiles_file;
+  FILE* contigs_file;
+  char* tmprofiles_file_name;
+  char* profiles_file_name;
+  char* contigs_file_name;
+  alignment_struct* alignments;
+  heap_struct sorter;
+  contig_struct contig_fwd;
+  contig_struct contig_rev;
+  int** reads_per_contig;
+  int ncontigs;
+  sere_struct* sere_s;
+  npidr_struct* npidr_s;
+} build_struct;
+
+/*
+ * build_init
+ *   Marks all the files and buffers of a build as not opened nor allocated
+ */
+void build_init(build_struct* build)
+{
+  memset(build, 0, sizeof(build_struct));
+}
+
+/*
+ * build_release
+ *   Closes the files, frees the buffers and deletes the temporal file of a failed build
+ */
+void build_release(build_struct* build, int nreplicates)
+{
+  int i;
+
+  for (i = 0; i < nreplicates; i++)
+    if (build->replicate_file[i] != NULL) samclose(build->replicate_file[i]);
+  if (build->tmprofiles_file != NULL) fclose(build->tmprofiles_file);
+  if (build->profiles_file != NULL) fclose(build->profiles_file);
+  if (build->contigs_file != NULL) fclose(build->contigs_file);
+  if (build->tmprofiles_file_name != NULL) unlink(build->tmprofiles_file_name);
+  free(build->tmprofiles_file_name);
+  free(build->profiles_file_name);
+  free(build->contigs_file_name);
+  free(build->alignments);
+  destroybh(&build->sorter);
+  free(build->contig_fwd.profile);
+  free(build->contig_fwd.nreads);
+  free(build->contig_rev.profile);
+  free(build->contig_rev.nreads);
+  if (build->reads_per_contig != NULL)
+    for (i = 0; i < build->ncontigs; i++) free(build->reads_per_contig[i]);
+  free(build->reads_per_contig);
+  if (build->sere_s != NULL) destroy_sere(build->sere_s);
+  if (build->npidr_s != NULL) destroy_npidr(build->npidr_s);
+}
+
+
+/*
+ * profiles_build
+ *
+ * @see include/profiles/profiles.h
+ */
+int profiles_build(args_p_struct* args, profile_list_struct* list, profiles_reserve reserve, void* data)
+{
+  // Define and declare variables
+  args_p_struct arguments = *args;                     // Command line parameters
+  build_struct build;                                  // Files and buffers released on failure
+  alignment_struct current_alignments[MAX_REPLICATES]; // Array of alignment_struct struct
+  int result;                                          // Result of any operation
+  int results[MAX_REPLICATES];                         // Replicate-specific results
+  int i, j, index, chridx, blkidx, maxstart;           // Multi-purpose indexes and checkpoint variables
+  char curr_chrom[MAX_FEATURE];                        // Current chromosome
+  int curr_len;                                        // Current length
+  int ncontigs;                                        // Number of contigs
+  profile_struct profile;                              // Profile struct
+
+  build_init(&build);
+
   // Open replicate file for reading and read BAM header
   // Exit if replicate BAM files do not exist, are not readable or do not have header
   for (index = 0; index < arguments.number_replicates; index++) {
-    if ((replicate_file[index] = samopen(arguments.replicate_f_path[index], "rb", 0)) == 0) {
+    if ((build.replicate_file[index] = samopen(arguments.replicate_f_path[index], "rb", 0)) == 0) {
       fprintf(stderr, "%s - %s\n", ERR_BAM_F_NOT_READABLE, arguments.replicate_f_path[index]);
+      build_release(&build, arguments.number_replicates);
       return(1);
     }
-    if (replicate_file[index]->header == 0) {
+    if (build.replicate_file[index]->header == 0) {
       fprintf(stderr, "%s - %s\n", ERR_BAM_F_NOT_HEADER, arguments.replicate_f_path[index]);
+      build_release(&build, arguments.number_replicates);
       return(1);
     }
   }
 
   // Check that all the replicates have reads in the same chromosomes
   // TODO => replicates can have different number of chromosomes
-  result = replicate_file[0]->header->n_targets;
+  result = build.replicate_file[0]->header->n_targets;
   for (i = 1; i < arguments.number_replicates; i++) {
-    if (replicate_file[0]->header->n_targets != result) {
+    if (build.replicate_file[0]->header->n_targets != result) {
       fprintf(stderr, "%s - %s\n", ERR_BAM_F_TRUNCATED, arguments.replicate_f_path[i]);
+      build_release(&build, arguments.number_replicates);
       return(1);
     }
   }
-  for (i = 0; i < replicate_file[0]->header->n_targets; i++) {
+  for (i = 0; i < build.replicate_file[0]->header->n_targets; i++) {
     for (j = 1; j < arguments.number_replicates; j++) {
-      if (strcmp(replicate_file[0]->header->target_name[i], replicate_file[j]->header->target_name[i]) != 0) {
+      if (strcmp(build.replicate_file[0]->header->target_name[i], build.replicate_file[j]->header->target_name[i]) != 0) {
         fprintf(stderr, "%s - %s\n", ERR_BAM_F_TRUNCATED, arguments.replicate_f_path[j]);
+        build_release(&build, arguments.number_replicates);
         return(1);
       }
     }
   }
 
   // Build absolute paths for temporal and output files
-  tmprofiles_file_name = malloc((MAX_PATH + strlen(TMPROFILES_SUFFIX) + 2) * sizeof(char));
-  strncpy(tmprofiles_file_name, arguments.output_f_path, MAX_PATH);
-  strcat(tmprofiles_file_name, PATH_SEPARATOR);
-  strcat(tmprofiles_file_name, TMPROFILES_SUFFIX);
-  profiles_file_name = malloc((MAX_PATH + strlen(PROFILES_SUFFIX) + 2) * sizeof(char));
-  strncpy(profiles_file_name, arguments.output_f_path, MAX_PATH);
-  strcat(profiles_file_name, PATH_SEPARATOR);
-  strcat(profiles_file_name, PROFILES_SUFFIX);
-  contigs_file_name = malloc((MAX_PATH + strlen(CONTIGS_SUFFIX) + 2) * sizeof(char));
-  strncpy(contigs_file_name, arguments.output_f_path, MAX_PATH);
-  strcat(contigs_file_name, PATH_SEPARATOR);
-  strcat(contigs_file_name, CONTIGS_SUFFIX);
+  build.tmprofiles_file_name = malloc((MAX_PATH + strlen(TMPROFILES_SUFFIX) + 2) * sizeof(char));
+  strncpy(build.tmprofiles_file_name, arguments.output_f_path, MAX_PATH);
+  strcat(build.tmprofiles_file_name, PATH_SEPARATOR);
+  strcat(build.tmprofiles_file_name, TMPROFILES_SUFFIX);
+  build.profiles_file_name = malloc((MAX_PATH + strlen(PROFILES_SUFFIX) + 2) * sizeof(char));
+  strncpy(build.profiles_file_name, arguments.output_f_path, MAX_PATH);
+  strcat(build.profiles_file_name, PATH_SEPARATOR);
+  strcat(build.profiles_file_name, PROFILES_SUFFIX);
+  build.contigs_file_name = malloc((MAX_PATH + strlen(CONTIGS_SUFFIX) + 2) * sizeof(char));
+  strncpy(build.contigs_file_name, arguments.output_f_path, MAX_PATH);
+  strcat(build.contigs_file_name, PATH_SEPARATOR);
+  strcat(build.contigs_file_name, CONTIGS_SUFFIX);
 
   // Open temporal output file for writing temporal results
-  tmprofiles_file = fopen(tmprofiles_file_name, "w");
-  if (!tmprofiles_file) {
+  build.tmprofiles_file = fopen(build.tmprofiles_file_name, "w");
+  if (!build.tmprofiles_file) {
     fprintf(stderr, "%s\n", ERR_OUTPUT_F_NOT_WRITABLE);
-    return (1);
+    build_release(&build, arguments.number_replicates);
+    return(1);
   }
 
   // Initialize variables for reading BAM files
   // Exit if BAM files are truncated or ill-formed, or if not enough memory
   fprintf(stderr, "[LOG] GENERATING PROFILES\n");
-  contig_fwd.start = 0; contig_fwd.end = 0; contig_rev.start = 0; contig_rev.end = 0;
   index = 0;
   chridx = 0;
   blkidx = 1;
-  strncpy(curr_chrom, replicate_file[0]->header->target_name[chridx], MAX_FEATURE);
-  curr_len = replicate_file[0]->header->target_len[chridx];
+  strncpy(curr_chrom, build.replicate_file[0]->header->target_name[chridx], MAX_FEATURE);
+  curr_len = build.replicate_file[0]->header->target_len[chridx];
   fprintf(stderr, "[LOG]   Parsing chromosome %s\n", curr_chrom);
 
   if (curr_len > (MAX_BLOCK * blkidx))
@@ -223,10 +528,11 @@ int profiles_sc(int argc, char **argv)
 
   for (i = 0; i < arguments.number_replicates; i++) {
     do {
-      results[i] = next_alignment(replicate_file[i], &current_alignments[i], i, &arguments);
+      results[i] = next_alignment(build.replicate_file[i], &current_alignments[i], i, &arguments);
     } while(results[i] > -1 && !current_alignments[i].valid);
     if (results[i] < 0) {
       fprintf(stderr, "%s\n", ERR_BAM_F_TRUNCATED);
+      build_release(&build, arguments.number_replicates);
       return(1);
     }
   }
@@ -234,17 +540,15 @@ int profiles_sc(int argc, char **argv)
   // Read BAM file and build sRNA profiles
   // Exit if BAM files are truncated or ill-formed, or if not enough memory
   while (morcgez(results, arguments.number_replicates)) {
-    alignment_struct* alignments;
     int alignment_counter = 0;
-    heap_struct sorter; 
 
-    alignments = (alignment_struct*) malloc (MAX_BLOCK * arguments.read_length * 2 * arguments.number_replicates * sizeof(alignment_struct));//TODO -> code read length in arguments
+    build.alignments = (alignment_struct*) malloc (MAX_BLOCK * arguments.read_length * 2 * arguments.number_replicates * sizeof(alignment_struct));//TODO -> code read length in arguments
 
     // Add all the reads in replicates to the alignments vector.
     // Collapse all the identical reads into one single alignment.
     for (i = 0; i < arguments.number_replicates; i++) {
       while ((results[i] > -1) &&
-             (strcmp(current_alignments[i].chromosome, curr_chrom) == 0) &&
+             (current_alignments[i].tid == chridx) &&
              (current_alignments[i].start <= maxstart))
       {
         int add_heap = 1;
@@ -252,46 +556,48 @@ int profiles_sc(int argc, char **argv)
         if(alignment_counter != 0) {
           int pointer = alignment_counter - 1;
 
-          while((add_heap == 1) && (pointer >= 0) && (current_alignments[i].start == alignments[pointer].start) &&
-                (strcmp(current_alignments[i].chromosome, alignments[pointer].chromosome) == 0)) {
-            if ((current_alignments[i].end == alignments[pointer].end) &&
-                (current_alignments[i].strand == alignments[pointer].strand) &&
-                (i == alignments[pointer].replicate)) {
+          while((add_heap == 1) && (pointer >= 0) && (current_alignments[i].start == build.alignments[pointer].start) &&
+                (current_alignments[i].tid == build.alignments[pointer].tid)) {
+            if ((current_alignments[i].end == build.alignments[pointer].end) &&
+                (current_alignments[i].strand == build.alignments[pointer].strand) &&
+                (i == build.alignments[pointer].replicate)) {
               add_heap = 0;
-              alignments[pointer].nreads++;
+              build.alignments[pointer].nreads++;
             }
             pointer--;
           }
         }
 
         if (add_heap) {
-          deepcpy(&alignments[alignment_counter], &current_alignments[i]);
+          deepcpy(&build.alignments[alignment_counter], &current_alignments[i]);
           alignment_counter++;
         }
 
         do {
-          results[i] = next_alignment(replicate_file[i], &current_alignments[i], i, &arguments);
+          results[i] = next_alignment(build.replicate_file[i], &current_alignments[i], i, &arguments);
         } while(results[i] > -1 && !current_alignments[i].valid);
       }
     }
 
     // Insert all alignments into heap
-    initbh(&sorter, alignment_counter);
-    for (i = 0; i < alignment_counter; i++) insertbh(&sorter, &alignments[i]);
+    initbh(&build.sorter, alignment_counter);
+    for (i = 0; i < alignment_counter; i++) insertbh(&build.sorter, &build.alignments[i]);
 
     // Process all elements in the heap
     for (i = 0; i < alignment_counter; i++) {
-      alignment_struct* algn = deletebh(&sorter);
+      alignment_struct* algn = deletebh(&build.sorter);
 
       if (algn->strand == FWD_STRAND) {
-        if (parse_alignment(&arguments, algn, &contig_fwd, tmprofiles_file) < 0) {
+        if (parse_alignment(&arguments, algn, &build.contig_fwd, build.tmprofiles_file) < 0) {
           fprintf(stderr, "%s\n", ERR_REALLOC_FAILED);
+          build_release(&build, arguments.number_replicates);
           return(1);
         }
       }
       else {
-        if (parse_alignment(&arguments, algn, &contig_rev, tmprofiles_file) < 0) {
+        if (parse_alignment(&arguments, algn, &build.contig_rev, build.tmprofiles_file) < 0) {
           fprintf(stderr, "%s\n", ERR_REALLOC_FAILED);
+          build_release(&build, arguments.number_replicates);
           return(1);
         }
       }
@@ -305,11 +611,11 @@ int profiles_sc(int argc, char **argv)
       maxstart = curr_len;
 
     // Check chromosome change
-    if (nmstrcmp(current_alignments, arguments.number_replicates, curr_chrom)) {
+    if (nmtidcmp(current_alignments, arguments.number_replicates, chridx)) {
       chridx++;
       blkidx = 1;
-      strncpy(curr_chrom, replicate_file[0]->header->target_name[chridx], MAX_FEATURE);
-      curr_len = replicate_file[0]->header->target_len[chridx];
+      strncpy(curr_chrom, build.replicate_file[0]->header->target_name[chridx], MAX_FEATURE);
+      curr_len = build.replicate_file[0]->header->target_len[chridx];
 
       if (curr_len > (MAX_BLOCK * blkidx))
         maxstart = MAX_BLOCK * blkidx;
@@ -319,134 +625,147 @@ int profiles_sc(int argc, char **argv)
       fprintf(stderr, "[LOG]   Parsing chromosome %s\n", curr_chrom);
     }
 
-    free(alignments);
-    destroybh(&sorter);
+    free(build.alignments);
+    build.alignments = NULL;
+    destroybh(&build.sorter);
   }
 
   // Flush the contig contents in the forward contig struct
-  fprintf(tmprofiles_file, "%s", contig_fwd.chromosome);
-  fprintf(tmprofiles_file, "\t%d", contig_fwd.start);
-  fprintf(tmprofiles_file, "\t%d", contig_fwd.end);
-  fprintf(tmprofiles_file, "\t%d", FWD_STRAND);
-  fprintf(tmprofiles_file, "\t%d", arguments.number_replicates);
-  for (i = 0; i < arguments.number_replicates; i++) fprintf(tmprofiles_file, "\t%d", contig_fwd.nreads[i]);
-  free(contig_fwd.nreads);
+  fprintf(build.tmprofiles_file, "%s", build.contig_fwd.chromosome);
+  fprintf(build.tmprofiles_file, "\t%d", build.contig_fwd.start);
+  fprintf(build.tmprofiles_file, "\t%d", build.contig_fwd.end);
+  fprintf(build.tmprofiles_file, "\t%d", FWD_STRAND);
+  fprintf(build.tmprofiles_file, "\t%d", arguments.number_replicates);
+  for (i = 0; i < arguments.number_replicates; i++) fprintf(build.tmprofiles_file, "\t%d", build.contig_fwd.nreads[i]);
+  free(build.contig_fwd.nreads);
+  build.contig_fwd.nreads = NULL;
 
   // Flush the profile contents in the forward contig struct if allowed by parameters
-  if ((gsl_stats_max(contig_fwd.profile, 1, (contig_fwd.end - contig_fwd.start + 1)) >= arguments.min_reads) &&  // Contig has more than r reads
-      ((contig_fwd.end - contig_fwd.start + 1) >= arguments.min_len))                                            // Contig has, at most, M nucleotides
+  if ((gsl_stats_max(build.contig_fwd.profile, 1, (build.contig_fwd.end - build.contig_fwd.start + 1)) >= arguments.min_reads) &&  // Contig has more than r reads
+      ((build.contig_fwd.end - build.contig_fwd.start + 1) >= arguments.min_len))                                            // Contig has, at most, M nucleotides
   {
-    fprintf(tmprofiles_file, "\t%d", contig_fwd.end - contig_fwd.start + 1);
-    for (i = 0; i < (contig_fwd.end - contig_fwd.start + 1); i++) {
+    fprintf(build.tmprofiles_file, "\t%d", build.contig_fwd.end - build.contig_fwd.start + 1);
+    for (i = 0; i < (build.contig_fwd.end - build.contig_fwd.start + 1); i++) {
       if (arguments.replicate_treat == REPLICATE_MEAN)
-        fprintf(tmprofiles_file, "\t%f", contig_fwd.profile[i] / ((double) arguments.number_replicates));
+        fprintf(build.tmprofiles_file, "\t%f", build.contig_fwd.profile[i] / ((double) arguments.number_replicates));
       else
-        fprintf(tmprofiles_file, "\t%f", contig_fwd.profile[i]);
+        fprintf(build.tmprofiles_file, "\t%f", build.contig_fwd.profile[i]);
     }
-    fprintf(tmprofiles_file, "\n");
+    fprintf(build.tmprofiles_file, "\n");
   }
   else
-    fprintf(tmprofiles_file, "\t%d\n", 0);
-  free(contig_fwd.profile);
+    fprintf(build.tmprofiles_file, "\t%d\n", 0);
+  free(build.contig_fwd.profile);
+  build.contig_fwd.profile = NULL;
 
   // Flush the contents in the reverse contig struct
-  fprintf(tmprofiles_file, "%s", contig_rev.chromosome);
-  fprintf(tmprofiles_file, "\t%d", contig_rev.start);
-  fprintf(tmprofiles_file, "\t%d", contig_rev.end);
-  fprintf(tmprofiles_file, "\t%d", REV_STRAND);
-  fprintf(tmprofiles_file, "\t%d", arguments.number_replicates);
-  for (i = 0; i < arguments.number_replicates; i++) fprintf(tmprofiles_file, "\t%d", contig_rev.nreads[i]);
-  free(contig_rev.nreads);
+  fprintf(build.tmprofiles_file, "%s", build.contig_rev.chromosome);
+  fprintf(build.tmprofiles_file, "\t%d", build.contig_rev.start);
+  fprintf(build.tmprofiles_file, "\t%d", build.contig_rev.end);
+  fprintf(build.tmprofiles_file, "\t%d", REV_STRAND);
+  fprintf(build.tmprofiles_file, "\t%d", arguments.number_replicates);
+  for (i = 0; i < arguments.number_replicates; i++) fprintf(build.tmprofiles_file, "\t%d", build.contig_rev.nreads[i]);
+  free(build.contig_rev.nreads);
+  build.contig_rev.nreads = NULL;
 
   // Flush the profile contents in the reverse contig struct if allowed by parameters
-  if ((gsl_stats_max(contig_rev.profile, 1, (contig_rev.end - contig_rev.start + 1)) >= arguments.min_reads) &&  // Contig has more than r reads
-      ((contig_rev.end - contig_rev.start + 1) >= arguments.min_len))                                            // Contig has, at most, M nucleotides
+  if ((gsl_stats_max(build.contig_rev.profile, 1, (build.contig_rev.end - build.contig_rev.start + 1)) >= arguments.min_reads) &&  // Contig has more than r reads
+      ((build.contig_rev.end - build.contig_rev.start + 1) >= arguments.min_len))                                            // Contig has, at most, M nucleotides
   {
-    fprintf(tmprofiles_file, "\t%d", contig_rev.end - contig_rev.start + 1);
-    for (i = 0; i < (contig_rev.end - contig_rev.start + 1); i++) {
+    fprintf(build.tmprofiles_file, "\t%d", build.contig_rev.end - build.contig_rev.start + 1);
+    for (i = 0; i < (build.contig_rev.end - build.contig_rev.start + 1); i++) {
       if (arguments.replicate_treat == REPLICATE_MEAN)
-        fprintf(tmprofiles_file, "\t%f", contig_rev.profile[contig_rev.end - contig_rev.start - i] / ((double) arguments.number_replicates));
+        fprintf(build.tmprofiles_file, "\t%f", build.contig_rev.profile[build.contig_rev.end - build.contig_rev.start - i] / ((double) arguments.number_replicates));
       else
-        fprintf(tmprofiles_file, "\t%f", contig_rev.profile[contig_rev.end - contig_rev.start - i]);
+        fprintf(build.tmprofiles_file, "\t%f", build.contig_rev.profile[build.contig_rev.end - build.contig_rev.start - i]);
     }
-    fprintf(tmprofiles_file, "\n");
+    fprintf(build.tmprofiles_file, "\n");
   }
   else
-    fprintf(tmprofiles_file, "\t%d\n", 0);
-  free(contig_rev.profile);
-  fclose(tmprofiles_file);
+    fprintf(build.tmprofiles_file, "\t%d\n", 0);
+  free(build.contig_rev.profile);
+  build.contig_rev.profile = NULL;
+  fclose(build.tmprofiles_file);
 
   // Count lines in profiles file
-  tmprofiles_file = fopen(tmprofiles_file_name, "r");
-  if (!tmprofiles_file) {
+  build.tmprofiles_file = fopen(build.tmprofiles_file_name, "r");
+  if (!build.tmprofiles_file) {
     fprintf(stderr, "%s\n", ERR_INPUT_F_NOT_READABLE);
-    return (1);
+    build_release(&build, arguments.number_replicates);
+    return(1);
   }
-  ncontigs = wcl(tmprofiles_file);
-  fclose(tmprofiles_file);
+  ncontigs = wcl(build.tmprofiles_file);
+  fclose(build.tmprofiles_file);
+  if (reserve != NULL)
+    reserve(contig_memory(ncontigs, arguments.number_replicates), data);
   
   // Allocate memory for storing irreproducibility data
-  reads_per_contig = (int**) malloc(ncontigs * sizeof(int*));
-  for (i = 0; i < ncontigs; i++) reads_per_contig[i] = (int*) malloc(arguments.number_replicates * sizeof(int));
+  build.reads_per_contig = (int**) malloc(ncontigs * sizeof(int*));
+  build.ncontigs = ncontigs;
+  for (i = 0; i < ncontigs; i++) build.reads_per_contig[i] = (int*) malloc(arguments.number_replicates * sizeof(int));
   
   // Read profiles and store irreproducibility and trimming data
-  tmprofiles_file = fopen(tmprofiles_file_name, "r");
-  if (!tmprofiles_file) {
+  build.tmprofiles_file = fopen(build.tmprofiles_file_name, "r");
+  if (!build.tmprofiles_file) {
     fprintf(stderr, "%s\n", ERR_INPUT_F_NOT_READABLE);
-    return (1);
+    build_release(&build, arguments.number_replicates);
+    return(1);
   }
   index = 0;
-  while((result = next_tmprofile(tmprofiles_file, &profile) > 0)) {
+  while((result = next_tmprofile(build.tmprofiles_file, &profile) > 0)) {
     for (i = 0; i < arguments.number_replicates; i++)
-      reads_per_contig[index][i] = profile.nreads[i];
+      build.reads_per_contig[index][i] = profile.nreads[i];
     free(profile.nreads);
     if (profile.free) free(profile.profile);
     index++;
   }
   if (result < 0) {
     fprintf(stderr, "%s\n", ERR_INPUT_F_NOT_READABLE);
+    build_release(&build, arguments.number_replicates);
     return(1);
   }
-  fclose(tmprofiles_file);
+  fclose(build.tmprofiles_file);
 
   // Open temporal file for reading profiles
   // Open profiles and contigs output files for writing results
   fprintf(stderr, "[LOG] CALCULATING IRREPRODUCIBILITY SCORES\n");
-  tmprofiles_file = fopen(tmprofiles_file_name, "r");
-  profiles_file = fopen(profiles_file_name, "w");
-  contigs_file = fopen(contigs_file_name, "w");
-  if (!tmprofiles_file) {
+  build.tmprofiles_file = fopen(build.tmprofiles_file_name, "r");
+  build.profiles_file = fopen(build.profiles_file_name, "w");
+  build.contigs_file = fopen(build.contigs_file_name, "w");
+  if (!build.tmprofiles_file) {
     fprintf(stderr, "%s\n", ERR_INPUT_F_NOT_READABLE);
-    return (1);
+    build_release(&build, arguments.number_replicates);
+    return(1);
   }
-  if (!profiles_file || !contigs_file) {
+  if (!build.profiles_file || !build.contigs_file) {
     fprintf(stderr, "%s\n", ERR_OUTPUT_F_NOT_WRITABLE);
-    return (1);
+    build_release(&build, arguments.number_replicates);
+    return(1);
   }
 
   // Generate data structures for ID
-  sere_s = create_sere(reads_per_contig, ncontigs, arguments.number_replicates);
-  npidr_s = create_npidr(reads_per_contig, ncontigs, arguments.number_replicates);
+  build.sere_s = create_sere(build.reads_per_contig, ncontigs, arguments.number_replicates);
+  build.npidr_s = create_npidr(build.reads_per_contig, ncontigs, arguments.number_replicates);
 
   // Read profiles and print results
   index = 0;
-  while((result = next_tmprofile(tmprofiles_file, &profile) > 0)) {
+  while((result = next_tmprofile(build.tmprofiles_file, &profile) > 0)) {
 
     // Calculate irreproducibility scores
     if (arguments.idr_method == IDR_SERE) 
-      calculate_sere_score(&profile, sere_s, arguments.number_replicates, arguments.idr_cutoff);
+      calculate_sere_score(&profile, build.sere_s, arguments.number_replicates, arguments.idr_cutoff);
     else if (arguments.idr_method == IDR_COMMON)
       calculate_common_score(&profile, arguments.number_replicates);
     else if (arguments.idr_method == IDR_IDR)
-      calculate_npidr_score(&profile, npidr_s, index, ncontigs, arguments.number_replicates, arguments.idr_cutoff);
+      calculate_npidr_score(&profile, build.npidr_s, index, ncontigs, arguments.number_replicates, arguments.idr_cutoff);
     else
       profile.idr_score = 0;
 
     // Print contig
-    fprintf(contigs_file, "%s\t%d\t%d\t%s", profile.chromosome, profile.start, profile.end, STR(profile.strand));
+    fprintf(build.contigs_file, "%s\t%d\t%d\t%s", profile.chromosome, profile.start, profile.end, STR(profile.strand));
     for (i = 0; i < arguments.number_replicates; i++)
-      fprintf(contigs_file, "\t%d", profile.nreads[i]);
-    fprintf(contigs_file, "\t%f\n", profile.idr_score);
+      fprintf(build.contigs_file, "\t%d", profile.nreads[i]);
+    fprintf(build.contigs_file, "\t%f\n", profile.idr_score);
 
     // Trim
     if (profile.valid)
@@ -488,10 +807,13 @@ int profiles_sc(int argc, char **argv)
                   prfpe = profile.end - (pstart - profile.tstart);
                   prfps = profile.end - (pend - profile.tstart);
                 }
-                fprintf(profiles_file, "%s:%d-%d:%s", profile.chromosome, prfps, prfpe, STR(profile.strand));
-                for (jx = pstart; jx <= pend; jx++)
-                  fprintf(profiles_file, "\t%f", profile.profile[jx]);
-                fprintf(profiles_file, "\n");
+                if (print_profile(build.profiles_file, list, profile.chromosome, prfps, prfpe, profile.strand, &profile.profile[pstart]) < 0) {
+                  fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+                  free(profile.nreads);
+                  if (profile.free) free(profile.profile);
+                  build_release(&build, arguments.number_replicates);
+                  return(1);
+                }
               }
               sstart = -1; send = -1;
               pstart = ix; pend = -1;
@@ -526,19 +848,25 @@ int profiles_sc(int argc, char **argv)
           prfpe = profile.end - (pstart - profile.tstart);
           prfps = profile.end - (pend - profile.tstart);
         }
-        fprintf(profiles_file, "%s:%d-%d:%s", profile.chromosome, prfps, prfpe, STR(profile.strand));
-        for (jx = pstart; jx <= pend; jx++)
-          fprintf(profiles_file, "\t%f", profile.profile[jx]);
-        fprintf(profiles_file, "\n");
+        if (print_profile(build.profiles_file, list, profile.chromosome, prfps, prfpe, profile.strand, &profile.profile[pstart]) < 0) {
+          fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+          free(profile.nreads);
+          if (profile.free) free(profile.profile);
+          build_release(&build, arguments.number_replicates);
+          return(1);
+        }
       }
     }
 
     // Print profile
     else if ((profile.valid) && (profile.length <= arguments.max_len)) {
-      fprintf(profiles_file, "%s:%d-%d:%s", profile.chromosome, profile.start, profile.end, STR(profile.strand));
-      for (i = profile.tstart; i <= profile.tend; i++)
-        fprintf(profiles_file, "\t%f", profile.profile[i]);
-      fprintf(profiles_file, "\n");
+      if (print_profile(build.profiles_file, list, profile.chromosome, profile.start, profile.end, profile.strand, &profile.profile[profile.tstart]) < 0) {
+        fprintf(stderr, "%s\n", ERR_NOT_ENOUGH_MEMORY);
+        free(profile.nreads);
+        if (profile.free) free(profile.profile);
+        build_release(&build, arguments.number_replicates);
+        return(1);
+      }
     }
 
     // Free structures in profile
@@ -549,26 +877,26 @@ int profiles_sc(int argc, char **argv)
   }
 
   // Destroy data structures for ID
-  destroy_sere(sere_s);
-  destroy_npidr(npidr_s);
+  destroy_sere(build.sere_s);
+  destroy_npidr(build.npidr_s);
 
   // Close file descriptors
-  fclose(tmprofiles_file);
-  fclose(profiles_file);
-  fclose(contigs_file);
+  fclose(build.tmprofiles_file);
+  fclose(build.profiles_file);
+  fclose(build.contigs_file);
   for(i = 0; i < arguments.number_replicates; i++)
-    samclose(replicate_file[i]);
+    samclose(build.replicate_file[i]);
 
   // Delete temporary files
-  result = unlink(tmprofiles_file_name);
+  result = unlink(build.tmprofiles_file_name);
 
   // Free pointers
-  free(tmprofiles_file_name);
-  free(profiles_file_name);
-  free(contigs_file_name);
+  free(build.tmprofiles_file_name);
+  free(build.profiles_file_name);
+  free(build.contigs_file_name);
   for (i = 0; i < index; i++)
-    free(reads_per_contig[i]);
-  free(reads_per_contig);
+    free(build.reads_per_contig[i]);
+  free(build.reads_per_contig);
 
   return(0);
 }
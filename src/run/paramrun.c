@@ -0,0 +1,97 @@
+#include <run/paramrun.h>
+
+/*
+ * parse_command_line_r
+ *
+ * @see include/run/paramrun.h
+ */
+int parse_command_line_r(int argc, char** argv, char** error_message, args_r_struct* arguments)
+{
+  opterr = 0;
+  char carg;
+  int terminate = 0;
+
+  while(((carg = getopt(argc, argv, "hvwf:i:r:t:p:a:o:j:k:s:d:c:")) != -1) && (terminate >= 0)) {
+    switch (carg) {
+      case 'h':
+        terminate--;
+        *error_message = RUN_HELP_MSG;
+        break;
+      case 'v':
+        terminate--;
+        *error_message = VERSION_MSG;
+        break;
+      case 'f':
+        terminate = parse_filter_parameters(optarg, error_message, &arguments->profiles);
+        break;
+      case 'i':
+        terminate = parse_irreproducibility_parameters(optarg, error_message, &arguments->profiles);
+        break;
+      case 'r':
+        terminate = parse_replicates_parameters(optarg, error_message, &arguments->profiles);
+        break;
+      case 'p':
+        terminate = parse_profiles_parameters(optarg, error_message, &arguments->profiles);
+        break;
+      case 't':
+        terminate = parse_trimming_parameters(optarg, error_message, &arguments->profiles);
+        break;
+      case 'w':
+        arguments->annotate.sweep = 1;
+        break;
+      case 'a':
+        terminate = parse_annotation_parameters(optarg, error_message, &arguments->annotate);
+        break;
+      case 'o':
+        terminate = parse_overlapping_parameters(optarg, error_message, &arguments->annotate);
+        break;
+      case 'j':
+        terminate = parse_threads_parameters(optarg, error_message, &arguments->annotate);
+        break;
+      case 'k':
+        if ((terminate = parse_prune_parameters(optarg, error_message, &arguments->annotate)) < 0)
+          *error_message = ERR_INVALID_k_VALUE;
+        break;
+      case 's':
+        terminate = parse_sparse_parameters(optarg, error_message, &arguments->annotate);
+        break;
+      case 'd':
+        terminate = parse_metric_parameters(optarg, error_message, &arguments->annotate);
+        break;
+      case 'c':
+        terminate = parse_clustering_parameters(optarg, error_message, &arguments->annotate);
+        break;
+      case '?':
+        terminate--;
+        *error_message = ERR_INVALID_ARGUMENT;
+    }
+  }
+
+  if (!terminate)
+    terminate = check_annotate_arguments(&arguments->annotate, error_message);
+
+  if (!terminate && (argc - optind) < 2) {
+    terminate--;
+    *error_message = ERR_INVALID_NUMBER_ARGUMENTS;
+  }
+  else if (!terminate && (argc - optind) > (MAX_REPLICATES + 1)) {
+    terminate--;
+    *error_message = ERR_INVALID_NUMBER_REPLICATES;
+  }
+  else if (!terminate) {
+    int i, j = 0;
+    for (i = optind; i < argc - 1; i++)
+      strncpy(arguments->profiles.replicate_f_path[j++], argv[i], MAX_PATH);
+    strncpy(arguments->profiles.output_f_path, argv[argc - 1], MAX_PATH);
+    strncpy(arguments->annotate.output_f_path, argv[argc - 1], MAX_PATH);
+    arguments->profiles.number_replicates = argc - optind - 1;
+  }
+
+  if ((arguments->profiles.replicate_treat == REPLICATE_REPLICATE) &&
+      (arguments->profiles.replicate_number > arguments->profiles.number_replicates)) {
+    terminate--;
+    *error_message = ERR_INVALID_repnumber_VALUE;
+  }
+
+  return(terminate);
+}
@@ -0,0 +1,50 @@
+#include <run/run.h>
+
+/*
+ * Application entry point
+ *   Profiles are built from the replicates and annotated in the same process.
+ *   The profiles file is still written, but annotate takes the profiles from memory.
+ */
+int run_sc(int argc, char **argv)
+{
+  // Define and declare variables
+  args_r_struct arguments;                             // Struct for handling command line parameters
+  char* error_message;                                 // Error message to display in case of abnormal termination
+  profile_list_struct list;                            // Profiles built in memory
+  int result;                                          // Result of any operation
+  int i;                                               // Multi-purpose index
+
+  // Initialize options with default values. Parse command line.
+  // Exit if command is not well-formed.
+  profiles_defaults(&arguments.profiles);
+  annotate_defaults(&arguments.annotate);
+  if (parse_command_line_r(argc, argv, &error_message, &arguments) < 0) {
+    fprintf(stderr, "%s\n", error_message);
+    if ((strcmp(error_message, RUN_HELP_MSG) == 0) || (strcmp(error_message, VERSION_MSG) == 0))
+      return(0);
+    fprintf(stderr, "%s\n", ERR_RUN_HELP_MSG);
+    return(1);
+  }
+
+  // Build profiles and keep them in memory
+  list.profiles = NULL;
+  list.size = 0;
+  list.capacity = 0;
+  // Exit if no profiles pass the filters
+  if ((result = profiles_build(&arguments.profiles, &list, NULL, NULL)) == 0) {
+    if (list.size == 0) {
+      fprintf(stderr, "%s\n", ERR_NO_PROFILES);
+      result = 1;
+    }
+
+    // Annotate and cluster the profiles
+    else
+      result = annotate_profiles(&arguments.annotate, list.profiles, list.size);
+  }
+
+  // Free profiles and exit
+  for (i = 0; i < list.size; i++)
+    free(list.profiles[i].profile);
+  free(list.profiles);
+  return(result);
+}
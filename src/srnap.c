@@ -19,6 +19,8 @@ int main(int argc, char** argv)
     return annotate_sc(argc - 1, argv + 1);
   else if (strcmp(argv[1], DIFFPROC_SUBCOMMAND) == 0)
     return diffproc_sc(argc - 1, argv + 1);
+  else if (strcmp(argv[1], RUN_SUBCOMMAND) == 0)
+    return run_sc(argc - 1, argv + 1);
   else if ((strcmp(argv[1], "-h") == 0) || (strcmp(argv[1], "--help") == 0)) {
     fprintf(stderr, "%s\n", GENERAL_HELP_MSG);
     return(0);